@@ -0,0 +1,76 @@
+#include <limits>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <functional>
+
+#include <floki/external_sort.hpp>
+
+using namespace std::chrono;
+
+// writes elements random keys to a file and times floki::external_sort on it.
+// compare the rate with the sequential bandwidth of the disk.
+template <typename T> void file_test(size_t elements,size_t memory_budget, const char* description)
+{
+    const std::string input_path = "external_sort_input.bin";
+    const std::string output_path = "external_sort_output.bin";
+
+    {
+        typedef typename std::conditional
+            <std::is_integral<T>::value, typename std::uniform_int_distribution<T>,
+             typename std::uniform_real_distribution<T>>::type distribution_t;
+        distribution_t distribution;
+        std::mt19937 engine;
+        auto generator = std::bind(distribution, engine);
+
+        std::ofstream file(input_path, std::ios::binary);
+        std::vector<T> values(1 << 20);
+        for (size_t written = 0; written < elements; written += values.size()) {
+            size_t count = std::min(values.size(), elements - written);
+            std::generate_n(begin(values), count, generator);
+            file.write(reinterpret_cast<const char *>(values.data()), count * sizeof(T));
+        }
+    }
+
+    std::cout << "starting benchmark external sorting " << elements << " " << description << "'s with a " << memory_budget / (1024 * 1024) << "MB budget. " << std::endl;
+
+    auto start = system_clock::now();
+    floki::external_sort<T>(input_path, output_path, memory_budget);
+    auto end = system_clock::now();
+
+    double total = (duration_cast<duration<float, std::milli>>(end - start)).count();
+    double megabytes = double(elements * sizeof(T)) / (1024 * 1024);
+
+    std::cout << "Sorted " << megabytes << "MB in " << total << " ms. "
+              << megabytes / (total / 1000) << "MB/s" << std::endl;
+
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    size_t elements = 256 * 1024 * 1024;
+    size_t memory_budget = 256 * 1024 * 1024;
+    uint32_t mode = 0;
+
+    if (argc > 1)
+        elements = atoll(argv[1]);
+    if (argc > 2)
+        memory_budget = atoll(argv[2]) * 1024 * 1024;
+    if (argc > 3)
+        mode = atoi(argv[3]);
+
+    switch (mode) {
+    case 1:
+        file_test<float>(elements,memory_budget,"float");
+        break;
+    default:
+        file_test<int32_t>(elements,memory_budget,"int32_t");
+    }
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+#include <floki/kary_search.hpp>
+
+using namespace std::chrono;
+
+// times building a breadth first k-ary tree with the recursive P() mapping
+// of the paper, the level by level floki::bfs::linearize, and the level by
+// level build on all threads, for trees of growing levels
+template <uint32_t k> void linearize_test(size_t max_elements, size_t iterations, unsigned threads)
+{
+    std::vector<int32_t> sorted(max_elements);
+    std::iota(begin(sorted), end(sorted), 0);
+    std::vector<int32_t> tree(max_elements);
+
+    std::cout << "k = " << k << std::endl;
+    std::cout << "elements | P() | level by level | " << threads
+              << " threads (M keys/s)" << std::endl;
+
+    for (size_t N = k * k; N - 1 <= max_elements; N *= k)
+    {
+        const size_t elements = N - 1;
+        double recursive_total = 0;
+        double level_total = 0;
+        double parallel_total = 0;
+
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto start = steady_clock::now();
+            std::copy(sorted.begin(), sorted.begin() + elements,
+                      floki::bfs::make_iterator(&tree[0], k, N, 0));
+            auto end = steady_clock::now();
+            recursive_total += (duration_cast<duration<double>>(end - start)).count();
+
+            start = steady_clock::now();
+            floki::bfs::linearize<k>(sorted.begin(), sorted.begin() + elements, tree.begin());
+            end = steady_clock::now();
+            level_total += (duration_cast<duration<double>>(end - start)).count();
+
+            start = steady_clock::now();
+            floki::bfs::linearize<k>(sorted.begin(), sorted.begin() + elements, tree.begin(), threads);
+            end = steady_clock::now();
+            parallel_total += (duration_cast<duration<double>>(end - start)).count();
+        }
+
+        const double keys = 1e-6 * elements * iterations;
+        std::cout << elements << " | " << keys / recursive_total << " | "
+                  << keys / level_total << " | " << keys / parallel_total << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t elements = 1 << 26;
+    size_t iterations = 5;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    if (argc > 1)
+        elements = atoi(argv[1]);
+    if (argc > 2)
+        iterations = atoi(argv[2]);
+    if (argc > 3)
+        threads = atoi(argv[3]);
+
+    linearize_test<5>(elements, iterations, threads);
+    linearize_test<9>(elements, iterations, threads);
+    linearize_test<17>(elements, iterations, threads);
+}
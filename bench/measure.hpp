@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+// the timing of the benchmarks: every case is run warmup times untimed and
+// then repetitions times with steady_clock, and summarized by the median,
+// p99 and min of the repetitions.
+
+struct options
+{
+    size_t max_elements = size_t(1) << 24;
+    size_t repetitions = 15;
+    size_t warmup = 2;
+};
+
+struct timing
+{
+    double median_ms;
+    double p99_ms;
+    double min_ms;
+};
+
+// times body repetitions times after warmup untimed runs. setup runs before
+// every call and is not timed.
+template <typename Setup, typename Body>
+timing measure(const options &opts, Setup setup, Body body)
+{
+    for (size_t i = 0; i < opts.warmup; ++i)
+    {
+        setup();
+        body();
+    }
+
+    std::vector<double> times;
+    for (size_t i = 0; i < opts.repetitions; ++i)
+    {
+        setup();
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(end - start)
+                            .count());
+    }
+
+    std::sort(begin(times), end(times));
+    size_t p99 = (times.size() * 99 + 99) / 100 - 1;
+    return timing{ times[times.size() / 2], times[std::min(p99, times.size() - 1)], times[0] };
+}
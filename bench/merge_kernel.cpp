@@ -0,0 +1,103 @@
+#include <limits>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <functional>
+#include <algorithm>
+
+#include <floki/aa_sort.hpp>
+
+using namespace std::chrono;
+
+// times one merge pass of floki::detail::merge_sort_branching, the kernel
+// with a branch on the selection, against the branch free merge_sort_width
+// kernel with 2, 4 and 8 vectors per step, for growing run lengths.
+
+const size_t lanes = floki::detail::sort_lanes<int32_t>::value;
+
+struct branching_kernel
+{
+    template <typename Input, typename Output>
+    void operator()(Input a, Input b, Output dest, size_t vectors) const
+    {
+        floki::detail::merge_sort_branching(a, b, dest, vectors, vectors);
+    }
+};
+
+template <size_t width> struct width_kernel
+{
+    template <typename Input, typename Output>
+    void operator()(Input a, Input b, Output dest, size_t vectors) const
+    {
+        floki::detail::merge_sort_width<width>(a, b, dest, vectors, vectors);
+    }
+};
+
+// merges adjacent runs of run_vectors vectors from values to output and
+// returns the throughput of the pass in MB/s.
+template <typename Kernel>
+double merge_pass_rate(std::vector<int32_t> &values, std::vector<int32_t> &output,
+                       size_t run_vectors, size_t iterations, Kernel kernel)
+{
+    using boost::simd::input_begin;
+    using boost::simd::output_begin;
+
+    const size_t vectors = values.size() / lanes;
+    double total = 0;
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        auto start = system_clock::now();
+        for (size_t v = 0; v + 2 * run_vectors <= vectors; v += 2 * run_vectors)
+        {
+            kernel(input_begin<lanes>(values.begin() + v * lanes),
+                   input_begin<lanes>(values.begin() + (v + run_vectors) * lanes),
+                   output_begin<lanes>(output.begin() + v * lanes), run_vectors);
+        }
+        auto end = system_clock::now();
+        total += (duration_cast<duration<double>>(end - start)).count();
+    }
+
+    return values.size() * sizeof(int32_t) * iterations / total / (1024 * 1024);
+}
+
+int main(int argc, char **argv)
+{
+    size_t elements = 1 << 22;
+    size_t iterations = 10;
+
+    if (argc > 1)
+        elements = atoi(argv[1]);
+    if (argc > 2)
+        iterations = atoi(argv[2]);
+
+    std::vector<int32_t> values(elements);
+    std::vector<int32_t> output(elements);
+
+    std::uniform_int_distribution<int32_t> distribution;
+    std::mt19937 engine;
+    std::generate(begin(values), end(values), [&] { return distribution(engine); });
+
+    std::cout << "merge pass of " << elements << " int32_t's, " << lanes << " lanes, MB/s" << std::endl;
+    std::cout << "run vectors | branching | width 2 | width 4 | width 8" << std::endl;
+
+    for (size_t run_vectors = 16; 2 * run_vectors * lanes <= elements; run_vectors *= 4)
+    {
+        // sorted runs of run_vectors vectors
+        for (size_t v = 0; v < elements; v += run_vectors * lanes)
+        {
+            std::sort(values.begin() + v,
+                      values.begin() + std::min(elements, v + run_vectors * lanes));
+        }
+
+        std::cout << run_vectors << " | "
+                  << merge_pass_rate(values, output, run_vectors, iterations, branching_kernel()) << " | "
+                  << merge_pass_rate(values, output, run_vectors, iterations, width_kernel<2>()) << " | "
+                  << merge_pass_rate(values, output, run_vectors, iterations, width_kernel<4>()) << " | "
+                  << merge_pass_rate(values, output, run_vectors, iterations, width_kernel<8>())
+                  << std::endl;
+    }
+
+    return 0;
+}
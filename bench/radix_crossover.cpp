@@ -0,0 +1,98 @@
+#include <limits>
+#include <vector>
+#include <iostream>
+#include <random>
+#include <algorithm>
+
+#include <floki/aa_sort.hpp>
+
+#include "measure.hpp"
+
+// times the AA sort merge passes against radix sort for growing sizes and
+// reports the first size where the median of radix sort is lower, the value
+// for floki::detail::radix_crossover. every run of a size sorts the same
+// random values, copied in untimed before it.
+//
+// usage: radix_crossover [max_elements] [repetitions] [mode]
+template <typename T> void crossover_test(const options &opts, const char *description)
+{
+    // uniform_int_distribution is not defined for 8 bit types
+    typedef typename std::conditional
+        <sizeof(T) == 1, int32_t, T>::type draw_t;
+    typedef typename std::conditional
+        <std::is_integral<T>::value, typename std::uniform_int_distribution<draw_t>,
+         typename std::uniform_real_distribution<T>>::type distribution_t;
+    distribution_t distribution;
+    std::mt19937 engine(1);
+
+    std::vector<T> source(opts.max_elements);
+    std::generate(begin(source), end(source), [&] { return static_cast<T>(distribution(engine)); });
+    std::vector<T> values(opts.max_elements);
+
+    floki::sort_workspace<T> workspace;
+    size_t crossover = 0;
+
+    std::cout << "crossover " << description << std::endl;
+    std::cout << "elements | aa sort | radix sort (median ms)" << std::endl;
+
+    for (size_t elements = 1024; elements <= opts.max_elements; elements *= 2)
+    {
+        auto temp = workspace.scratch(elements);
+        auto reset = [&] { std::copy(begin(source), begin(source) + elements, begin(values)); };
+
+        timing aa = measure(opts, reset, [&] {
+            floki::detail::sort_range(values.begin(), values.begin() + elements, temp);
+        });
+        timing radix = measure(opts, reset, [&] {
+            floki::detail::radix_sort_range(values.begin(), values.begin() + elements, temp);
+        });
+
+        std::cout << elements << " | " << aa.median_ms << " | " << radix.median_ms << std::endl;
+
+        if (!crossover && radix.median_ms < aa.median_ms)
+            crossover = elements;
+    }
+
+    std::cout << "radix sort wins from " << crossover << " " << description << "'s" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    uint32_t mode = 0;
+
+    if (argc > 1)
+        opts.max_elements = atoll(argv[1]);
+    if (argc > 2)
+        opts.repetitions = std::max(1, atoi(argv[2]));
+    if (argc > 3)
+        mode = atoi(argv[3]);
+
+    switch (mode) {
+    case 1:
+        crossover_test<float>(opts, "float");
+        break;
+    case 2:
+        crossover_test<double>(opts, "double");
+        break;
+    case 3:
+        crossover_test<int16_t>(opts, "int16_t");
+        break;
+    case 4:
+        crossover_test<uint16_t>(opts, "uint16_t");
+        break;
+    case 5:
+        crossover_test<uint8_t>(opts, "uint8_t");
+        break;
+    case 6:
+        crossover_test<int64_t>(opts, "int64_t");
+        break;
+    case 7:
+        crossover_test<uint64_t>(opts, "uint64_t");
+        break;
+    default:
+        crossover_test<int32_t>(opts, "int32_t");
+    }
+
+    return 0;
+}
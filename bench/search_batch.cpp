@@ -0,0 +1,74 @@
+
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <numeric>
+
+#include <floki/kary_index.hpp>
+
+using namespace std::chrono;
+
+// times random lookups in a floki::kary_index one key at a time with search,
+// in batches with floki::bfs::search_batch, and with std::lower_bound, for
+// indexes growing past the last level cache
+template <uint32_t k> void search_batch_test(size_t max_elements, size_t lookups)
+{
+    std::mt19937 engine(1);
+    std::uniform_int_distribution<int32_t> distribution;
+
+    std::vector<int32_t> keys(lookups);
+    std::generate(begin(keys), end(keys), [&] { return distribution(engine); });
+    std::vector<size_t> positions(lookups);
+
+    std::cout << "k = " << k << std::endl;
+    std::cout << "elements | search | search_batch | std::lower_bound (M lookups/s)" << std::endl;
+
+    for (size_t elements = 1 << 16; elements <= max_elements; elements *= 4)
+    {
+        std::vector<int32_t> sorted(elements);
+        std::generate(begin(sorted), end(sorted), [&] { return distribution(engine); });
+        std::sort(begin(sorted), end(sorted));
+
+        floki::kary_index<int32_t, k> index(begin(sorted), end(sorted));
+
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < lookups; ++i)
+            positions[i] = index.search(keys[i]);
+        auto end = steady_clock::now();
+        double single = (duration_cast<duration<double>>(end - start)).count();
+        size_t check = std::accumulate(begin(positions), std::end(positions), size_t(0));
+
+        start = steady_clock::now();
+        floki::bfs::search_batch(index, keys.data(), lookups, positions.begin());
+        end = steady_clock::now();
+        double batch = (duration_cast<duration<double>>(end - start)).count();
+        if (check != std::accumulate(begin(positions), std::end(positions), size_t(0)))
+            std::cout << "search_batch does not match search" << std::endl;
+
+        start = steady_clock::now();
+        for (size_t i = 0; i < lookups; ++i)
+            positions[i] = std::lower_bound(begin(sorted), std::end(sorted), keys[i]) - begin(sorted);
+        end = steady_clock::now();
+        double stl = (duration_cast<duration<double>>(end - start)).count();
+
+        const double m = 1e-6 * lookups;
+        std::cout << elements << " | " << m / single << " | " << m / batch
+                  << " | " << m / stl << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    size_t elements = 1 << 26;
+    size_t lookups = 1 << 22;
+
+    if (argc > 1)
+        elements = atoi(argv[1]);
+    if (argc > 2)
+        lookups = atoi(argv[2]);
+
+    search_batch_test<9>(elements, lookups);
+    search_batch_test<17>(elements, lookups);
+}
@@ -6,7 +6,13 @@
 #include <random>
 #include <functional>
 
-#ifdef SIMD_BENCH
+#if defined(PARALLEL_BENCH)
+#include <floki/parallel_sort.hpp>
+#elif defined(MULTIWAY_BENCH)
+#include <floki/multiway_sort.hpp>
+#elif defined(RADIX_BENCH)
+#include <floki/radix_sort.hpp>
+#elif defined(SIMD_BENCH)
 #include <floki/aa_sort.hpp>
 #else
 #include <algorithm>
@@ -17,13 +23,16 @@ using namespace std::chrono;
 template <typename T> void random_test(size_t elements,size_t iteratations, const char* description)
 {
     std::vector<T> values(elements);
+    // uniform_int_distribution is not defined for 8 bit types
     typedef typename std::conditional
-        <std::is_integral<T>::value, typename std::uniform_int_distribution<T>,
+        <sizeof(T) == 1, int32_t, T>::type draw_t;
+    typedef typename std::conditional
+        <std::is_integral<T>::value, typename std::uniform_int_distribution<draw_t>,
          typename std::uniform_real_distribution<T>>::type distribution_t;
     distribution_t distribution;
     std::mt19937 engine;
     auto generator = std::bind(distribution, engine);
-    std::generate_n(begin(values), elements, generator);
+    std::generate_n(begin(values), elements, [&] { return static_cast<T>(generator()); });
 
     double total = 0;
 
@@ -34,7 +43,13 @@ template <typename T> void random_test(size_t elements,size_t iteratations, cons
     {
         std::random_shuffle(values.begin(),values.end());
         auto start = system_clock::now();
-#ifdef SIMD_BENCH
+#if defined(PARALLEL_BENCH)
+        floki::parallel_sort(values.begin(), values.end());
+#elif defined(MULTIWAY_BENCH)
+        floki::multiway_sort(values.begin(), values.end());
+#elif defined(RADIX_BENCH)
+        floki::radix_sort(values.begin(), values.end());
+#elif defined(SIMD_BENCH)
         floki::sort(values.begin(), values.end());
 #else
         std::sort(values.begin(), values.end());
@@ -44,7 +59,7 @@ template <typename T> void random_test(size_t elements,size_t iteratations, cons
         total += (duration_cast<duration<float, std::milli>>(end - start)).count();
     }
     std::cout << "Sorted " << elements << " " << iteratations << " times in " << total
-              << " ms. mean " << total / iteratations <<  "ms. first value " << values[0]  <<  std::endl;
+              << " ms. mean " << total / iteratations <<  "ms. first value " << +values[0]  <<  std::endl;
 }
 
 int main(int argc, char **argv)
@@ -67,6 +82,21 @@ int main(int argc, char **argv)
     case 2:
         random_test<double>(elements,iterations,"double");
         break;
+    case 3:
+        random_test<int16_t>(elements,iterations,"int16_t");
+        break;
+    case 4:
+        random_test<uint16_t>(elements,iterations,"uint16_t");
+        break;
+    case 5:
+        random_test<uint8_t>(elements,iterations,"uint8_t");
+        break;
+    case 6:
+        random_test<int64_t>(elements,iterations,"int64_t");
+        break;
+    case 7:
+        random_test<uint64_t>(elements,iterations,"uint64_t");
+        break;
     default:
         random_test<int32_t>(elements,iterations,"int32_t");
     }
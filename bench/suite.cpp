@@ -0,0 +1,249 @@
+#include <limits>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <string>
+
+#include <floki/aa_sort.hpp>
+#include <floki/algorithms.hpp>
+#include <floki/kary_search.hpp>
+
+#include "measure.hpp"
+
+// benchmark suite for floki::sort, floki::find_if and floki::bfs::search.
+// every case is run warmup times untimed and then repetitions times with
+// steady_clock, and the median and p99 of the repetitions are written as
+// one JSON document, for tracking in CI.
+//
+// usage: bench_suite [max_elements] [repetitions] [output.json]
+
+// collects the results as a JSON array of objects
+class json_report
+{
+public:
+    void add(const std::string &benchmark, const std::string &algorithm,
+             const std::string &type, const std::string &distribution,
+             size_t elements, const timing &t, size_t repetitions)
+    {
+        std::ostringstream record;
+        record << "    {\"benchmark\": \"" << benchmark << "\", \"algorithm\": \"" << algorithm
+               << "\", \"type\": \"" << type << "\", \"distribution\": \"" << distribution
+               << "\", \"elements\": " << elements << ", \"repetitions\": " << repetitions
+               << ", \"median_ms\": " << t.median_ms << ", \"p99_ms\": " << t.p99_ms
+               << ", \"min_ms\": " << t.min_ms << "}";
+        m_records.push_back(record.str());
+
+        std::cerr << benchmark << " " << algorithm << " " << type << " " << distribution
+                  << " " << elements << ": median " << t.median_ms << "ms p99 " << t.p99_ms
+                  << "ms" << std::endl;
+    }
+
+    void write(std::ostream &out) const
+    {
+        out << "{\n  \"suite\": \"floki\",\n  \"results\": [\n";
+        for (size_t i = 0; i < m_records.size(); ++i)
+        {
+            out << m_records[i] << (i + 1 < m_records.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    std::vector<std::string> m_records;
+};
+
+const char *distributions[] = { "random", "sorted", "reversed", "few_unique", "zipf", "sawtooth" };
+
+// input of elements values with the named distribution
+template <typename T> std::vector<T> make_input(const std::string &distribution, size_t elements)
+{
+    std::vector<T> values(elements);
+    std::mt19937 engine(static_cast<uint32_t>(elements));
+
+    if (distribution == "few_unique")
+    {
+        std::uniform_int_distribution<int32_t> draw(0, 15);
+        std::generate(begin(values), end(values), [&] { return T(draw(engine) * 1000); });
+    }
+    else if (distribution == "zipf")
+    {
+        // ranks drawn with probability 1 / rank, over up to 64K distinct values
+        size_t distinct = std::min<size_t>(elements, 1 << 16);
+        std::vector<double> weights(distinct);
+        for (size_t r = 0; r < distinct; ++r)
+            weights[r] = 1.0 / (r + 1);
+        std::discrete_distribution<int32_t> draw(begin(weights), end(weights));
+        std::generate(begin(values), end(values), [&] { return T(draw(engine)); });
+    }
+    else if (distribution == "sawtooth")
+    {
+        // 64 ascending teeth
+        size_t tooth = std::max<size_t>(1, elements / 64);
+        for (size_t i = 0; i < elements; ++i)
+            values[i] = T(i % tooth);
+    }
+    else
+    {
+        std::uniform_int_distribution<int32_t> draw(std::numeric_limits<int32_t>::min() / 2,
+                                                    std::numeric_limits<int32_t>::max() / 2);
+        std::generate(begin(values), end(values), [&] { return T(draw(engine)); });
+        if (distribution == "sorted")
+            std::sort(begin(values), end(values));
+        else if (distribution == "reversed")
+            std::sort(begin(values), end(values), std::greater<T>());
+    }
+
+    return values;
+}
+
+// sizes from L1 resident to DRAM sized
+std::vector<size_t> sweep(size_t first, size_t max_elements)
+{
+    std::vector<size_t> sizes;
+    for (size_t elements = first; elements <= max_elements; elements *= 4)
+        sizes.push_back(elements);
+    return sizes;
+}
+
+template <typename T>
+void sort_suite(const options &opts, json_report &report, const char *type)
+{
+    for (size_t elements : sweep(1024, opts.max_elements))
+    {
+        for (const char *distribution : distributions)
+        {
+            const auto input = make_input<T>(distribution, elements);
+            std::vector<T> values(elements);
+            auto reset = [&] { std::copy(begin(input), end(input), begin(values)); };
+
+            floki::sort_workspace<T> workspace;
+            report.add("sort", "floki::sort", type, distribution, elements,
+                       measure(opts, reset, [&] { floki::sort(begin(values), end(values), workspace); }),
+                       opts.repetitions);
+            report.add("sort", "std::sort", type, distribution, elements,
+                       measure(opts, reset, [&] { std::sort(begin(values), end(values)); }),
+                       opts.repetitions);
+            report.add("sort", "std::stable_sort", type, distribution, elements,
+                       measure(opts, reset, [&] { std::stable_sort(begin(values), end(values)); }),
+                       opts.repetitions);
+        }
+    }
+}
+
+const size_t queries = 1024;
+
+// the lookups add their results here, so they are not optimized away
+volatile size_t sink;
+
+// queries lookups of random keys in sorted ranges of each size. find_if is a
+// linear scan, so it is only run up to 64K elements.
+void find_if_suite(const options &opts, json_report &report)
+{
+    using std::placeholders::_1;
+
+    for (size_t elements : sweep(64, std::min<size_t>(opts.max_elements, 1 << 16)))
+    {
+        auto values = make_input<int32_t>("sorted", elements);
+        auto keys = make_input<int32_t>("random", queries);
+        const int32_t *first = values.data();
+        const int32_t *last = first + elements;
+        size_t found = 0;
+
+        report.add("find_if", "floki::find_if", "int32_t", "random", elements,
+                   measure(opts, [] {}, [&] {
+                       for (auto key : keys)
+                           found += floki::find_if(first, last, std::bind(floki::greater_equal(), _1, key)) - first;
+                   }),
+                   opts.repetitions);
+        report.add("find_if", "std::find_if", "int32_t", "random", elements,
+                   measure(opts, [] {}, [&] {
+                       for (auto key : keys)
+                           found += std::find_if(first, last, [&](int32_t v) { return v >= key; }) - first;
+                   }),
+                   opts.repetitions);
+
+        sink = found;
+    }
+}
+
+// queries lookups in complete k-ary trees of each depth, against
+// std::lower_bound on the sorted values.
+void search_suite(const options &opts, json_report &report)
+{
+    const uint32_t k = boost::simd::native<int32_t, BOOST_SIMD_DEFAULT_EXTENSION>::static_size + 1;
+
+    // the keys are int32_t values 0 to N - 2
+    const size_t max_elements = std::min<size_t>(
+        opts.max_elements, std::numeric_limits<int32_t>::max());
+
+    for (size_t N = k * k; N - 1 <= max_elements; N *= k)
+    {
+        std::vector<int32_t> sorted_values(N - 1);
+        std::iota(begin(sorted_values), end(sorted_values), 0);
+        std::vector<int32_t> linearized(N - 1);
+        floki::bfs::linearize<k>(begin(sorted_values), end(sorted_values), begin(linearized));
+
+        std::mt19937 engine(static_cast<uint32_t>(N));
+        std::uniform_int_distribution<int32_t> draw(0, static_cast<int32_t>(N - 2));
+        std::vector<int32_t> keys(queries);
+        std::generate(begin(keys), end(keys), [&] { return draw(engine); });
+        size_t found = 0;
+
+        report.add("search", "floki::bfs::search", "int32_t", "random", N - 1,
+                   measure(opts, [] {}, [&] {
+                       for (auto key : keys)
+                           found += floki::bfs::search<int32_t, k>(&linearized[0], &linearized[N - 1], key);
+                   }),
+                   opts.repetitions);
+        report.add("search", "std::lower_bound", "int32_t", "random", N - 1,
+                   measure(opts, [] {}, [&] {
+                       for (auto key : keys)
+                           found += std::lower_bound(begin(sorted_values), end(sorted_values), key) - begin(sorted_values);
+                   }),
+                   opts.repetitions);
+
+        sink = found;
+
+        // the next N would pass max_elements, or wrap
+        if (N > max_elements / k)
+            break;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    options opts;
+    const char *output = nullptr;
+
+    if (argc > 1)
+        opts.max_elements = atoll(argv[1]);
+    if (argc > 2)
+        opts.repetitions = std::max(1, atoi(argv[2]));
+    if (argc > 3)
+        output = argv[3];
+
+    json_report report;
+
+    sort_suite<int32_t>(opts, report, "int32_t");
+    sort_suite<float>(opts, report, "float");
+    find_if_suite(opts, report);
+    search_suite(opts, report);
+
+    if (output)
+    {
+        std::ofstream file(output);
+        report.write(file);
+    }
+    else
+    {
+        report.write(std::cout);
+    }
+
+    return 0;
+}
@@ -1,10 +1,17 @@
 #pragma once
 
 #include <vector>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <numeric>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <cmath>
+#include <utility>
 
+#include <boost/simd/include/pack.hpp>
 #include <boost/simd/memory/allocator.hpp>
 
 #include <boost/simd/include/functions/simd/interleave_first.hpp>
@@ -13,6 +20,9 @@
 #include <boost/simd/include/functions/simd/shuffle.hpp>
 #include <boost/simd/include/functions/simd/min.hpp>
 #include <boost/simd/include/functions/simd/max.hpp>
+#include <boost/simd/include/functions/simd/if_else.hpp>
+#include <boost/simd/include/functions/simd/is_less.hpp>
+#include <boost/simd/include/functions/simd/bitwise_cast.hpp>
 
 #include <boost/simd/memory/input_iterator.hpp>
 #include <boost/simd/memory/output_iterator.hpp>
@@ -22,117 +32,154 @@
 
 #include <boost/tuple/tuple.hpp>
 
+#include <floki/order.hpp>
+#include <floki/sort_stats.hpp>
+#include <floki/sort_workspace.hpp>
+#include <floki/radix_sort.hpp>
+
 namespace floki
 {
 
 namespace detail
 {
+#include <floki/detail/order.hpp>
 #include <floki/detail/aa_sort.hpp>
+#include <floki/detail/key_value.hpp>
 }
 
 /**
  * sorts vector in place using AA sort algorithm.
  * http://seven-degrees-of-freedom.blogspot.com/2010/07/question-of-sorts.html
  *
+ * the overload taking a sort_workspace reuses its scratch memory across
+ * calls. a workspace made with scratch_size::half sorts with n / 2 elements
+ * of scratch.
+ * built with FLOKI_SORT_RADIX defined, an ascending sort uses radix_sort
+ * instead from detail::radix_crossover elements on.
+ *
+ * Order is a compile time sort order from floki/order.hpp, e.g.
+ * floki::sort<floki::descending>(first, last). it is built into the
+ * compare exchange of the sorting networks, so no pass reverses or
+ * transforms the data.
  */
-template <class RandomAccessIterator>
+template <class Order = ascending, class RandomAccessIterator>
+inline void sort(RandomAccessIterator first, RandomAccessIterator last,
+                 sort_workspace<typename std::iterator_traits
+                                <RandomAccessIterator>::value_type> &workspace)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    auto elements = std::distance(first, last);
+    auto temp = workspace.scratch(elements);
+
+    if (workspace.size() == scratch_size::full
+        && std::is_same<Order, ascending>::value
+        && detail::radix_crossover<value_type>::enabled
+        && size_t(elements) >= detail::radix_crossover<value_type>::value) {
+        detail::radix_sort_range(first, last, temp);
+    } else if (workspace.size() == scratch_size::full) {
+        detail::sort_range<Order>(first, last, temp);
+    } else {
+        detail::sort_range_half<Order>(first, last, temp);
+    }
+}
+
+template <class Order = ascending, class RandomAccessIterator>
 inline void sort(RandomAccessIterator first, RandomAccessIterator last)
 {
-    using boost::simd::pack;
-    using boost::simd::input_end;
+    sort_workspace<typename std::iterator_traits
+                   <RandomAccessIterator>::value_type> workspace;
+
+    sort<Order>(first, last, workspace);
+}
+
+/**
+ * sorts keys in place using AA sort algorithm and applies the same
+ * permutation to the values that start at values_first.
+ * the values are carried through the same sorting network as the keys, so
+ * keys and values must have the same size, e.g. int32_t keys with uint32_t
+ * row ids.
+ */
+template <class KeyIterator, class ValueIterator>
+inline void sort_by_key(KeyIterator keys_first, KeyIterator keys_last,
+                        ValueIterator values_first)
+{
     using boost::simd::input_begin;
     using boost::simd::output_begin;
 
     using boost::simd::aligned_input_begin;
     using boost::simd::aligned_output_begin;
 
-    using boost::tuples::tie;
-
     using boost::simd::allocator;
 
-    typedef typename RandomAccessIterator::value_type value_type;
-
-    using vector_t = std::vector<value_type, allocator<value_type>>;
+    typedef typename KeyIterator::value_type key_type;
+    typedef typename ValueIterator::value_type value_type;
 
-    using pack_t = pack<value_type, 4>;
+    static_assert(sizeof(key_type) == sizeof(value_type),
+                  "sort_by_key requires keys and values of the same size");
 
-    auto elements = std::distance(first, last);
+    using key_vector_t = std::vector<key_type, allocator<key_type>>;
+    using value_vector_t = std::vector<value_type, allocator<value_type>>;
 
-    //elements not a multiple of 16 must be handled special
-    auto non_simd_elements = elements % 16;
+    const size_t lanes = detail::sort_lanes<key_type>::value;
 
-    // sorting begins with size 16 blocks.
-    auto sort_block_elements = elements - non_simd_elements;
+    auto elements = std::distance(keys_first, keys_last);
 
-    // typedef typename vector_t::iterator it_t;
-    auto vb = input_begin<4>(first);
-    auto ve = input_end<4>(first + sort_block_elements);
-    auto vo = output_begin<4>(first);
-
-    while (vb < ve) {
-        pack_t a = *vb++;
-        pack_t b = *vb++;
-        pack_t c = *vb++;
-        pack_t d = *vb++;
-
-        tie(a, b, c, d) = detail::bitonic_sort_16(a, b, c, d);
-        *vo++ = a;
-        *vo++ = b;
-        *vo++ = c;
-        *vo++ = d;
-    }
+    //elements not a multiple of the block size must be handled special
+    const size_t block_elements = lanes * detail::block_vectors<lanes>::value;
 
-    vector_t temp(sort_block_elements);
+    auto non_simd_elements = elements % block_elements;
 
-    // compute the number of passes
-    auto loops = sort_block_elements ? static_cast
-                     <int32_t>(std::floor(std::log2(sort_block_elements / 16)))
-                               : 0;
+    // sorting begins with blocks of block_elements elements.
+    auto sort_block_elements = elements - non_simd_elements;
 
-    size_t merge_size = 4;
+    auto data_in = detail::key_value_input(input_begin<lanes>(keys_first),
+                                           input_begin<lanes>(values_first));
+    auto data_out = detail::key_value_output(output_begin<lanes>(keys_first),
+                                             output_begin<lanes>(values_first));
 
-    // now always run iterations per pass
+    detail::sort_blocks(data_in, data_out, sort_block_elements);
 
-    size_t remainder = 0;
-    for (size_t loop = 0; loop < loops - 1; loop += 2) {
-        remainder = detail::merge_pass(input_begin<4>(first),
-                                        aligned_output_begin<4>(begin(temp)),
-                                        sort_block_elements, merge_size,remainder);
-        merge_size *= 2;
-        remainder = detail::merge_pass(aligned_input_begin<4>(begin(temp)),
-                                        output_begin<4>(first), sort_block_elements,
-                                        merge_size, remainder);
-        merge_size *= 2;
-    }
+    key_vector_t key_temp(elements);
+    value_vector_t value_temp(elements);
 
-    // run post fix for odd number of loops
-    if (loops % 2 == 1) {
-        remainder = detail::merge_pass(input_begin<4>(first),
-                                        aligned_output_begin<4>(begin(temp)),
-                                        sort_block_elements, merge_size,remainder);
-        merge_size *= 2;
-        if (remainder) {
-            //perform a merge of the remaining 2 blocks.
-            detail::merge_sort(aligned_input_begin<4>(begin(temp)), aligned_input_begin<4>(end(temp)  - remainder * 4), output_begin<4>(first),
-                           merge_size, remainder);
-        }
-        else {
-            std::copy(begin(temp), end(temp), first);
-        }
-    }
-    else {
-        if (remainder) {
-            //perform a merge of the remaining 2 blocks.
-            detail::merge_sort(input_begin<4>(first), input_begin<4>(last - non_simd_elements - (remainder * 4)), aligned_output_begin<4>(begin(temp)),
-                           merge_size, remainder);
-            std::copy(begin(temp), end(temp), first);
-        }
-    }
+    detail::merge_passes(
+        data_in, data_out,
+        detail::key_value_input(aligned_input_begin<lanes>(begin(key_temp)),
+                                aligned_input_begin<lanes>(begin(value_temp))),
+        detail::key_value_output(aligned_output_begin<lanes>(begin(key_temp)),
+                                 aligned_output_begin<lanes>(begin(value_temp))),
+        sort_block_elements);
 
     if (non_simd_elements) {
-        //use standard algorithm to finish off if array as not multiple of 16
-        std::sort(last - non_simd_elements, last);
-        std::inplace_merge(first,last - non_simd_elements, last);
+        detail::merge_tail_by_key(keys_first, values_first, elements,
+                                  non_simd_elements, begin(key_temp),
+                                  begin(value_temp));
     }
 }
+
+/**
+ * returns the permutation that sorts [first, last) without moving the input.
+ * indices[i] is the position in the input of the i'th smallest element.
+ * a copy of the keys is sorted with sort_by_key while the indices ride along
+ * as the values. 64 bit keys carry 64 bit indices through the network.
+ */
+template <class RandomAccessIterator>
+inline std::vector<uint32_t> argsort(RandomAccessIterator first,
+                                     RandomAccessIterator last)
+{
+    typedef typename RandomAccessIterator::value_type value_type;
+    typedef typename detail::index_of<value_type>::type index_type;
+
+    assert(std::distance(first, last) <= std::numeric_limits<uint32_t>::max());
+
+    std::vector<value_type, boost::simd::allocator<value_type>> keys(first, last);
+    std::vector<index_type> indices(keys.size());
+    std::iota(begin(indices), end(indices), index_type(0));
+
+    sort_by_key(begin(keys), end(keys), begin(indices));
+
+    return detail::to_indices(std::move(indices));
+}
 };
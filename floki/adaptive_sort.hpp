@@ -0,0 +1,54 @@
+#pragma once
+
+#include <floki/aa_sort.hpp>
+
+#include <boost/simd/include/functions/hmsb.hpp>
+#include <boost/simd/include/functions/ffs.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/runs.hpp>
+}
+
+/**
+ * sorts vector in place, merging the sorted runs already in the input.
+ *
+ * a vectorized scan finds ascending and descending runs and reverses the
+ * descending ones. where there is no long run, 4096 elements are sorted with
+ * the AA sort kernels. the runs are then merged pairwise with the bitonic
+ * merge kernels. sorted and reverse sorted input costs about one pass, a few
+ * appended sorted runs cost one pass per doubling of the runs merged, and
+ * random input costs about the same as floki::sort.
+ */
+template <class RandomAccessIterator>
+inline void adaptive_sort(RandomAccessIterator first, RandomAccessIterator last)
+{
+    typedef typename RandomAccessIterator::value_type value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+    const size_t elements = std::distance(first, last);
+
+    sort_workspace<value_type> workspace;
+    auto temp = workspace.scratch(elements);
+
+    auto bounds = detail::find_runs(first, last, temp, detail::adaptive_min_run);
+
+    bool in_temp = false;
+
+    while (bounds.size() > 2) {
+        if (in_temp) {
+            bounds = detail::merge_runs<lanes>(temp, first, bounds);
+        } else {
+            bounds = detail::merge_runs<lanes>(first, temp, bounds);
+        }
+        in_temp = !in_temp;
+    }
+
+    if (in_temp) {
+        std::copy(temp, temp + elements, first);
+    }
+}
+};
@@ -14,6 +14,96 @@ using boost::tuples::tuple;
 using boost::tuples::tie;
 using boost::tuples::make_tuple;
 
+/**
+ * lanes per vector used to sort value_type.
+ * keys use the full native register of BOOST_SIMD_DEFAULT_EXTENSION, capped
+ * at 16 lanes so that a sort block stays in registers:
+ *   8 and 16 bit keys: 16 lanes (8 lanes for 16 bit keys on SSE)
+ *   32 bit keys: 4 lanes for SSE, 8 lanes for AVX and 16 lanes for AVX-512
+ *   64 bit keys: 2 lanes for SSE, 4 lanes for AVX and 8 lanes for AVX-512
+ */
+template <typename value_type>
+struct sort_lanes
+    : std::integral_constant<
+          size_t,
+          (boost::simd::native<value_type,
+                               BOOST_SIMD_DEFAULT_EXTENSION>::static_size > 16
+               ? 16
+               : boost::simd::native<value_type,
+                                     BOOST_SIMD_DEFAULT_EXTENSION>::static_size)>
+{
+};
+
+/**
+ * vectors per sort block. merge_sort needs runs of at least 4 vectors, so
+ * 2 lane vectors sort 2 squares of 2 vectors per block.
+ */
+template <size_t lanes>
+struct block_vectors : std::integral_constant<size_t, (lanes < 4 ? 4 : lanes)>
+{
+};
+
+/**
+ * vectors merge_sort takes from a run per step. more vectors per step give
+ * more independent compares between the selections. the width is capped at
+ * block_vectors, since runs are a multiple of a sort block.
+ */
+#ifndef FLOKI_MERGE_VECTORS
+#define FLOKI_MERGE_VECTORS 4
+#endif
+
+template <size_t lanes>
+struct merge_width
+    : std::integral_constant<size_t, (FLOKI_MERGE_VECTORS < block_vectors<lanes>::value
+                                          ? FLOKI_MERGE_VECTORS
+                                          : block_vectors<lanes>::value)>
+{
+};
+
+/**
+ * bytes merge_sort prefetches ahead of its reads of each run.
+ */
+const size_t merge_prefetch_bytes = 512;
+
+/**
+ * compile time list of lane indices, used to build shuffle masks for any
+ * number of lanes.
+ */
+template <int... indices> struct lane_list
+{
+};
+
+template <int lanes, int... indices>
+struct make_lane_list : make_lane_list<lanes - 1, lanes - 1, indices...>
+{
+};
+
+template <int... indices> struct make_lane_list<0, indices...>
+{
+    using type = lane_list<indices...>;
+};
+
+/**
+ * swaps lane i with lane i ^ distance
+ */
+template <int distance, typename simd_type, int... indices>
+inline simd_type exchange_lanes(simd_type a, lane_list<indices...>)
+{
+    return shuffle<(indices ^ distance)...>(a);
+}
+
+/**
+ * takes lane i from lo when bit distance of i is clear. otherwise takes lane
+ * i ^ distance from hi, so both halves of a pair come from the same compare.
+ */
+template <int distance, typename simd_type, int... indices>
+inline simd_type select_lanes(simd_type lo, simd_type hi, lane_list<indices...>)
+{
+    return shuffle<((indices & distance)
+                        ? (indices ^ distance) + int(sizeof...(indices))
+                        : indices)...>(lo, hi);
+}
+
 /**
  * simd minmax
  * returns a 2 element tuple where the elements are defined as follows.
@@ -113,7 +203,8 @@ bitmerge3(simd_type a, simd_type b, simd_type c, simd_type d)
     return make_tuple(a, b, c, d);
 }
 
-template <typename simd_type> inline simd_type bitmerge1(simd_type XYZW)
+template <typename simd_type>
+inline simd_type bitmerge1(simd_type XYZW, std::integral_constant<size_t, 4>)
 {
     simd_type min1, max1, min2, max2;
 
@@ -129,6 +220,47 @@ template <typename simd_type> inline simd_type bitmerge1(simd_type XYZW)
     return shuffle<0, 4, 2, 6>(min2, max2);
 }
 
+/**
+ * in register bitonic merge for any number of lanes.
+ * each step compares the lanes distance apart and halves distance.
+ */
+template <int distance> struct in_register_merge
+{
+    template <typename simd_type> static simd_type apply(simd_type a)
+    {
+        using lanes_t = typename make_lane_list<simd_type::static_size>::type;
+
+        simd_type lo, hi;
+        tie(lo, hi) = minmax(a, exchange_lanes<distance>(a, lanes_t()));
+        return in_register_merge<distance / 2>::apply(
+            select_lanes<distance>(lo, hi, lanes_t()));
+    }
+};
+
+template <> struct in_register_merge<0>
+{
+    template <typename simd_type> static simd_type apply(simd_type a)
+    {
+        return a;
+    }
+};
+
+template <typename simd_type, size_t lanes>
+inline simd_type bitmerge1(simd_type a, std::integral_constant<size_t, lanes>)
+{
+    return in_register_merge<lanes / 2>::apply(a);
+}
+
+/**
+ * sorts a vector holding a bitonic sequence.
+ * 4 lane vectors use the hand scheduled shuffles above.
+ */
+template <typename simd_type> inline simd_type bitmerge1(simd_type a)
+{
+    return bitmerge1(a,
+                     std::integral_constant<size_t, simd_type::static_size>());
+}
+
 template <typename simd_type>
 inline tuple<simd_type, simd_type, simd_type, simd_type>
 bitonic_merge(simd_type a, simd_type b, simd_type c, simd_type d)
@@ -145,10 +277,238 @@ bitonic_merge(simd_type a, simd_type b, simd_type c, simd_type d)
 }
 
 /**
+ * loads the next 2 vector group of a sorted run. a run with less than 2
+ * vectors of elements left is padded with the sentinel of its order, which
+ * sorts to the end of a merge.
+ */
+template <typename simd_type, typename InputIterator>
+inline void load_group(InputIterator &first, size_t &elements, simd_type &lo,
+                       simd_type &hi)
+{
+    using boost::simd::input_begin;
+    using value_type = typename simd_type::value_type;
+    using order = typename order_of<simd_type>::type;
+    const size_t lanes = simd_type::static_size;
+
+    if (elements >= 2 * lanes) {
+        auto in = input_begin<lanes>(first);
+        lo = simd_type(*in++);
+        hi = simd_type(*in);
+        first += 2 * lanes;
+        elements -= 2 * lanes;
+    } else {
+        value_type buffer[2 * lanes];
+        std::fill(std::copy(first, first + elements, buffer),
+                  buffer + 2 * lanes, order::template sentinel<value_type>());
+        auto in = input_begin<lanes>(&buffer[0]);
+        lo = simd_type(*in++);
+        hi = simd_type(*in);
+        first += elements;
+        elements = 0;
+    }
+}
+
+/**
+ * stores a 2 vector group, writing no more than elements values.
+ */
+template <typename simd_type, typename OutputIterator>
+inline void store_group(OutputIterator &dest, size_t &elements, simd_type lo,
+                        simd_type hi)
+{
+    using boost::simd::output_begin;
+    using value_type = typename simd_type::value_type;
+    const size_t lanes = simd_type::static_size;
+
+    if (elements >= 2 * lanes) {
+        auto out = output_begin<lanes>(dest);
+        *out++ = unordered(lo);
+        *out = unordered(hi);
+        dest += 2 * lanes;
+        elements -= 2 * lanes;
+    } else {
+        value_type buffer[2 * lanes];
+        auto out = output_begin<lanes>(&buffer[0]);
+        *out++ = unordered(lo);
+        *out = unordered(hi);
+        dest = std::copy(buffer, buffer + elements, dest);
+        elements = 0;
+    }
+}
+
+/**
+ * merges 2 sorted runs of any length.
+ * unlike merge_sort the runs do not have to be a multiple of 2 vectors and
+ * can start anywhere in memory. the last group of each run is padded with
+ * sentinels, which end up at the end of the merge and are never written.
+ * the runs are sorted in Order.
+ */
+template <size_t lanes, typename Order = ascending, typename InputIterator1,
+          typename InputIterator2, typename OutputIterator>
+inline void merge_n(InputIterator1 a, size_t a_elements, InputIterator2 b,
+                    size_t b_elements, OutputIterator dest)
+{
+    using value_type = typename std::iterator_traits<InputIterator1>::value_type;
+    using simd_type_t = typename ordered_type
+        <boost::simd::pack<value_type, lanes>, Order>::type;
+
+    if (!a_elements) {
+        std::copy(b, b + b_elements, dest);
+        return;
+    }
+    if (!b_elements) {
+        std::copy(a, a + a_elements, dest);
+        return;
+    }
+
+    size_t remaining = a_elements + b_elements;
+    simd_type_t a1, a2, b1, b2;
+
+    load_group(a, a_elements, a1, a2);
+    load_group(b, b_elements, b1, b2);
+
+    for (;;) {
+        tie(a1, a2, b1, b2) = bitonic_merge(a1, a2, b1, b2);
+        store_group(dest, remaining, a1, a2);
+        a1 = b1;
+        a2 = b2;
+
+        if (a_elements && (!b_elements || Order::less(*a, *b))) {
+            load_group(a, a_elements, b1, b2);
+        } else if (b_elements) {
+            load_group(b, b_elements, b1, b2);
+        } else {
+            break;
+        }
+    }
+
+    store_group(dest, remaining, a1, a2);
+}
+
+template <typename simd_type>
+inline tuple<simd_type, simd_type, simd_type, simd_type>
+bitonic_sort_16(simd_type a, simd_type b, simd_type c, simd_type d)
+{
+
+    // sort 16 values
+
+    tie(a, b, c, d) = sort_columns(a, b, c, d);
+    tie(a, b, c, d) = transpose4(a, b, c, d);
+
+    tie(a, b) = merge_sorted_vectors(a, b);
+    tie(c, d) = merge_sorted_vectors(c, d);
+    return bitonic_merge(a, b, c, d);
+}
+
+/**
+ * bitonic merge of the 2 sorted runs v[0, count / 2) and v[count / 2, count)
+ * for any number of lanes. this is bitonic_merge generalized to runs of more
+ * than 2 vectors.
+ */
+template <typename simd_type>
+inline void bitonic_merge_vectors(simd_type *v, size_t count)
+{
+    const size_t half = count / 2;
+
+    // compare against the reversed second run, the upper half comes out in
+    // reverse vector order.
+    for (size_t i = 0; i < half; ++i) {
+        tie(v[i], v[count - 1 - i]) = minmax(v[i], reverse(v[count - 1 - i]));
+    }
+    std::reverse(v + half, v + count);
+
+    for (size_t distance = half / 2; distance > 0; distance /= 2) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!(i & distance)) {
+                tie(v[i], v[i + distance]) = minmax(v[i], v[i + distance]);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        v[i] = bitmerge1(v[i]);
+    }
+}
+
+/**
+ * sorts the columns of count vectors with a bitonic sorting network, so that
+ * v[0][j] <= v[1][j] <= ... <= v[count - 1][j] for every lane j.
+ */
+template <typename simd_type>
+inline void sort_vector_columns(simd_type *v, size_t count)
+{
+    for (size_t size = 2; size <= count; size *= 2) {
+        for (size_t group = 0; group < count; group += size) {
+            for (size_t i = 0; i < size / 2; ++i) {
+                tie(v[group + i], v[group + size - 1 - i])
+                    = minmax(v[group + i], v[group + size - 1 - i]);
+            }
+        }
+        for (size_t distance = size / 4; distance > 0; distance /= 2) {
+            for (size_t i = 0; i < count; ++i) {
+                if (!(i & distance)) {
+                    tie(v[i], v[i + distance]) = minmax(v[i], v[i + distance]);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * transposes a square matrix of count vectors with count lanes.
+ * each round interleaves vector i with vector i + count / 2, which rotates
+ * the bits of the row and column index by one. log2(count) rounds swap them.
+ */
+template <typename simd_type>
+inline void transpose_vectors(simd_type *v, size_t count)
+{
+    for (size_t round = 1; round < count; round *= 2) {
+        simd_type t[simd_type::static_size];
+        for (size_t i = 0; i < count / 2; ++i) {
+            t[2 * i] = interleave_first(v[i], v[i + count / 2]);
+            t[2 * i + 1] = interleave_second(v[i], v[i + count / 2]);
+        }
+        std::copy(t, t + count, v);
+    }
+}
+
+/**
+ * sorts a block of count vectors, count * lanes values.
+ * generalizes bitonic_sort_16 to 8 lane (64 values) and 16 lane (256 values)
+ * vectors. each square of lanes vectors is column sorted and transposed, then
+ * the sorted vectors are merged. this also covers blocks of more vectors than
+ * lanes.
+ */
+template <typename simd_type, size_t count>
+inline void bitonic_sort_block(simd_type (&v)[count])
+{
+    const size_t lanes = simd_type::static_size;
+
+    for (size_t square = 0; square < count; square += lanes) {
+        sort_vector_columns(v + square, lanes);
+        transpose_vectors(v + square, lanes);
+    }
+
+    for (size_t size = 2; size <= count; size *= 2) {
+        for (size_t group = 0; group < count; group += size) {
+            bitonic_merge_vectors(v + group, size);
+        }
+    }
+}
+
+template <typename simd_type>
+inline typename std::enable_if<simd_type::static_size == 4>::type
+bitonic_sort_block(simd_type (&v)[4])
+{
+    tie(v[0], v[1], v[2], v[3]) = bitonic_sort_16(v[0], v[1], v[2], v[3]);
+}
+
+/**
+ * the merge kernel before merge_sort, 2 vectors per step with a branch on
+ * the selection. kept for the merge_kernel benchmark.
  * this function does not work inplace if a_merge_size != b_merge_size
  */
 template <typename input_type, typename output_type>
-inline void merge_sort(input_type a, input_type b, output_type dest,
+inline void merge_sort_branching(input_type a, input_type b, output_type dest,
                        size_t a_merge_size, size_t b_merge_size)
 {
     assert(a_merge_size >= 4);
@@ -173,7 +533,7 @@ inline void merge_sort(input_type a, input_type b, output_type dest,
         a2 = b2;
 
         // reference the underlying iterator
-        if ((*a.base()) < (*b.base())) {
+        if (order_of<simd_type_t>::type::less(*a.base(), *b.base())) {
             b1 = *a++;
             b2 = *a++;
         } else {
@@ -213,19 +573,138 @@ inline void merge_sort(input_type a, input_type b, output_type dest,
     *dest++ = a2;
 }
 
+/**
+ * prefetches merge_prefetch_bytes ahead of the scalar position of it. the
+ * address is only computed as an integer, a prefetch past the end of the
+ * data does not fault.
+ */
+template <typename Iterator> inline void prefetch_ahead(Iterator it)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(reinterpret_cast<const char *>(
+        reinterpret_cast<uintptr_t>(&*it) + merge_prefetch_bytes));
+#endif
+}
+
+/**
+ * merges the 2 sorted runs v[0, count / 2) and v[count / 2, count).
+ */
 template <typename simd_type>
-inline tuple<simd_type, simd_type, simd_type, simd_type>
-bitonic_sort_16(simd_type a, simd_type b, simd_type c, simd_type d)
+inline void merge_vectors(simd_type (&v)[4])
 {
+    tie(v[0], v[1], v[2], v[3]) = bitonic_merge(v[0], v[1], v[2], v[3]);
+}
 
-    // sort 16 values
+template <typename simd_type, size_t count>
+inline void merge_vectors(simd_type (&v)[count])
+{
+    bitonic_merge_vectors(v, count);
+}
 
-    tie(a, b, c, d) = sort_columns(a, b, c, d);
-    tie(a, b, c, d) = transpose4(a, b, c, d);
+/**
+ * merges 2 sorted runs of vectors from a and b into dest.
+ * each step merges vectors vectors of output and loads vectors vectors from
+ * the run with the smaller next value. the run is picked with a select on
+ * the offsets of the runs from a instead of a branch, which would mispredict
+ * about half the time on random data, and both runs are prefetched ahead.
+ * the runs must be parts of one buffer, b reachable from a, and their sizes
+ * multiples of vectors.
+ * this function does not work inplace if a_merge_size != b_merge_size
+ */
+template <size_t vectors, typename input_type, typename output_type>
+inline void merge_sort_width(input_type a, input_type b, output_type dest,
+                             size_t a_merge_size, size_t b_merge_size)
+{
+    using simd_type_t = typename input_type::value_type;
+    using order = typename order_of<simd_type_t>::type;
+    using offset_t = std::ptrdiff_t;
 
-    tie(a, b) = merge_sorted_vectors(a, b);
-    tie(c, d) = merge_sorted_vectors(c, d);
-    return bitonic_merge(a, b, c, d);
+    assert(a_merge_size >= vectors && a_merge_size % vectors == 0);
+    assert(b_merge_size >= vectors && b_merge_size % vectors == 0);
+
+    simd_type_t v[2 * vectors];
+    for (size_t i = 0; i < vectors; ++i) {
+        v[i] = *(a + i);
+    }
+    for (size_t i = 0; i < vectors; ++i) {
+        v[vectors + i] = *(b + i);
+    }
+
+    // the positions of the runs in vectors from a. a select on the iterator
+    // adaptors is not guaranteed to compile to a cmov, one on integers is,
+    // so the loop advances offsets and rebuilds the iterator it loads from
+    const offset_t b_first = b - a;
+    const offset_t a_end = offset_t(a_merge_size);
+    const offset_t b_end = b_first + offset_t(b_merge_size);
+    offset_t a_next = offset_t(vectors);
+    offset_t b_next = b_first + offset_t(vectors);
+
+    // both runs have vectors left
+    while (a_next != a_end && b_next != b_end) {
+        prefetch_ahead((a + a_next).base());
+        prefetch_ahead((a + b_next).base());
+
+        const offset_t take_a
+            = order::less(*(a + a_next).base(), *(a + b_next).base());
+
+        merge_vectors(v);
+        for (size_t i = 0; i < vectors; ++i) {
+            *dest++ = v[i];
+            v[i] = v[vectors + i];
+        }
+
+        input_type next = a + (b_next + take_a * (a_next - b_next));
+        for (size_t i = 0; i < vectors; ++i) {
+            v[vectors + i] = *next++;
+        }
+        a_next += take_a * offset_t(vectors);
+        b_next += (1 - take_a) * offset_t(vectors);
+    }
+
+    input_type rest = a + (a_next != a_end ? a_next : b_next);
+    input_type rest_end = a + (a_next != a_end ? a_end : b_end);
+
+    for (;;) {
+        merge_vectors(v);
+        for (size_t i = 0; i < vectors; ++i) {
+            *dest++ = v[i];
+            v[i] = v[vectors + i];
+        }
+        if (rest == rest_end) {
+            break;
+        }
+        for (size_t i = 0; i < vectors; ++i) {
+            v[vectors + i] = *rest++;
+        }
+    }
+
+    for (size_t i = 0; i < vectors; ++i) {
+        *dest++ = v[i];
+    }
+}
+
+/**
+ * merges 2 sorted runs of vectors from a and b into dest, with
+ * merge_width vectors per step when both run sizes allow it and 2 vectors
+ * otherwise. the runs must be parts of one buffer and their sizes multiples
+ * of 2 vectors, at least 4.
+ * this function does not work inplace if a_merge_size != b_merge_size
+ */
+template <typename input_type, typename output_type>
+inline void merge_sort(input_type a, input_type b, output_type dest,
+                       size_t a_merge_size, size_t b_merge_size)
+{
+    const size_t vectors
+        = merge_width<input_type::value_type::static_size>::value;
+
+    assert(a_merge_size >= 4);
+    assert(b_merge_size >= 4);
+
+    if (a_merge_size % vectors == 0 && b_merge_size % vectors == 0) {
+        merge_sort_width<vectors>(a, b, dest, a_merge_size, b_merge_size);
+    } else {
+        merge_sort_width<2>(a, b, dest, a_merge_size, b_merge_size);
+    }
 }
 
 template <class InputIterator, class OutputIterator>
@@ -233,14 +712,17 @@ inline size_t merge_pass(InputIterator input,
                                         OutputIterator output, size_t elements,
                                         size_t merge_size, size_t remainder)
 {
+    FLOKI_SORT_PHASE("merge pass");
+
+    const size_t lanes = InputIterator::value_type::static_size;
 
     size_t i = 0;
-    for (; i <= elements / 4 - 2 * merge_size; i += 2 * merge_size) {
+    for (; i <= elements / lanes - 2 * merge_size; i += 2 * merge_size) {
         detail::merge_sort(input + i, input + (i + merge_size), output + i,
                            merge_size, merge_size);
     }
     //if there are an odd number of sort blocks, there will be a remainder.
-    size_t remain = i < (elements / 4) - remainder ? merge_size : 0;
+    size_t remain = i < (elements / lanes) - remainder ? merge_size : 0;
 
     //if there is a previous remainder from another pass
     if (remainder) {
@@ -261,3 +743,227 @@ inline size_t merge_pass(InputIterator input,
 
     return remainder;
 }
+
+/**
+ * sorts each block of block_vectors vectors in the first elements of input
+ * and writes the blocks to output.
+ */
+template <class InputIterator, class OutputIterator>
+inline void sort_blocks(InputIterator input, OutputIterator output,
+                        size_t elements)
+{
+    FLOKI_SORT_PHASE("block sort");
+
+    using simd_type_t = typename InputIterator::value_type;
+    const size_t lanes = simd_type_t::static_size;
+    const size_t vectors = block_vectors<lanes>::value;
+
+    auto input_end = input + elements / lanes;
+
+    while (input < input_end) {
+        simd_type_t block[vectors];
+        for (size_t i = 0; i < vectors; ++i) {
+            block[i] = *input++;
+        }
+
+        bitonic_sort_block(block);
+
+        for (size_t i = 0; i < vectors; ++i) {
+            *output++ = block[i];
+        }
+    }
+}
+
+/**
+ * runs all merge passes over elements that are sorted in blocks of
+ * block_vectors vectors.
+ * passes alternate between data and temp, and the result ends up in data.
+ * both are given as an input and an output vector iterator and temp must
+ * hold at least elements values.
+ * with leave_in_temp a result that would be copied from temp to data is left
+ * in temp instead. returns true if the result is in temp.
+ */
+template <class DataInput, class DataOutput, class TempInput, class TempOutput>
+inline bool merge_passes(DataInput data_in, DataOutput data_out,
+                         TempInput temp_in, TempOutput temp_out,
+                         size_t elements, bool leave_in_temp = false)
+{
+    const size_t lanes = DataInput::value_type::static_size;
+    const size_t vectors = block_vectors<lanes>::value;
+
+    // compute the number of passes
+    size_t loops = elements ? static_cast
+                       <size_t>(std::floor(std::log2(elements / (lanes * vectors))))
+                            : 0;
+
+    size_t merge_size = vectors;
+
+    // now always run iterations per pass
+
+    size_t remainder = 0;
+    for (size_t loop = 0; loop + 1 < loops; loop += 2) {
+        remainder = merge_pass(data_in, temp_out, elements, merge_size,
+                               remainder);
+        merge_size *= 2;
+        remainder = merge_pass(temp_in, data_out, elements, merge_size,
+                               remainder);
+        merge_size *= 2;
+    }
+
+    // run post fix for odd number of loops
+    if (loops % 2 == 1) {
+        remainder = merge_pass(data_in, temp_out, elements, merge_size,
+                               remainder);
+        merge_size *= 2;
+        if (remainder) {
+            //perform a merge of the remaining 2 blocks.
+            FLOKI_SORT_PHASE("remainder merge");
+            merge_sort(temp_in, temp_in + (elements / lanes - remainder), data_out,
+                       merge_size, remainder);
+        }
+        else if (leave_in_temp) {
+            return true;
+        }
+        else {
+            std::copy(temp_in, temp_in + elements / lanes, data_out);
+        }
+    }
+    else {
+        if (remainder) {
+            //perform a merge of the remaining 2 blocks.
+            FLOKI_SORT_PHASE("remainder merge");
+            merge_sort(data_in, data_in + (elements / lanes - remainder), temp_out,
+                       merge_size, remainder);
+            if (leave_in_temp) {
+                return true;
+            }
+            std::copy(temp_in, temp_in + elements / lanes, data_out);
+        }
+    }
+    return false;
+}
+
+/**
+ * sorts the last elements % block_elements elements of [first, last), which
+ * do not fill a block, and merges them with the sorted blocks before them.
+ * the tail is padded with sentinels to a full block and sorted in registers
+ * with bitonic_sort_block. the sorted blocks are in temp when blocks_in_temp,
+ * then the merge replaces the copy back to data. otherwise only the blocks
+ * greater than the smallest tail element are moved to temp and merged back.
+ */
+template <size_t lanes, class Order, class RandomAccessIterator,
+          class TempIterator>
+inline void merge_tail(RandomAccessIterator first, RandomAccessIterator last,
+                       TempIterator temp, size_t tail_elements,
+                       bool blocks_in_temp)
+{
+    FLOKI_SORT_PHASE("tail merge");
+
+    using boost::simd::input_begin;
+    using boost::simd::output_begin;
+
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t block_elements = lanes * block_vectors<lanes>::value;
+
+    value_type tail[block_elements];
+    std::fill(std::copy(last - tail_elements, last, tail), tail + block_elements,
+              Order::template sentinel<value_type>());
+
+    sort_blocks(order_view<Order>::input(input_begin<lanes>(&tail[0])),
+                order_view<Order>::output(output_begin<lanes>(&tail[0])),
+                block_elements);
+
+    size_t block_elements_sorted = std::distance(first, last) - tail_elements;
+
+    if (blocks_in_temp) {
+        merge_n<lanes, Order>(temp, block_elements_sorted, &tail[0],
+                              tail_elements, first);
+        return;
+    }
+
+    auto moved = std::upper_bound(first, first + block_elements_sorted, tail[0],
+                                  Order::template less<value_type>);
+    size_t moved_elements = first + block_elements_sorted - moved;
+
+    std::copy(moved, moved + moved_elements, temp);
+    merge_n<lanes, Order>(temp, moved_elements, &tail[0], tail_elements, moved);
+}
+
+/**
+ * AA sort of [first, last) in Order using temp as scratch space for the merge
+ * passes. temp must hold last - first elements and be aligned for aligned
+ * vector loads, e.g. memory from boost::simd::allocator.
+ */
+template <class Order = ascending, class RandomAccessIterator,
+          class TempIterator>
+inline void sort_range(RandomAccessIterator first, RandomAccessIterator last,
+                       TempIterator temp)
+{
+    using boost::simd::input_begin;
+    using boost::simd::output_begin;
+
+    using boost::simd::aligned_input_begin;
+    using boost::simd::aligned_output_begin;
+
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t lanes = sort_lanes<value_type>::value;
+
+    auto elements = std::distance(first, last);
+
+    //elements not a multiple of the block size must be handled special
+    const size_t block_elements = lanes * block_vectors<lanes>::value;
+
+    auto non_simd_elements = elements % block_elements;
+
+    // sorting begins with blocks of block_elements elements.
+    auto sort_block_elements = elements - non_simd_elements;
+
+    auto data_in = order_view<Order>::input(input_begin<lanes>(first));
+    auto data_out = order_view<Order>::output(output_begin<lanes>(first));
+
+    sort_blocks(data_in, data_out, sort_block_elements);
+
+    bool blocks_in_temp = merge_passes(
+        data_in, data_out,
+        order_view<Order>::input(aligned_input_begin<lanes>(temp)),
+        order_view<Order>::output(aligned_output_begin<lanes>(temp)),
+        sort_block_elements, non_simd_elements != 0);
+
+    if (non_simd_elements) {
+        merge_tail<lanes, Order>(first, last, temp, non_simd_elements,
+                                 blocks_in_temp);
+    }
+}
+
+/**
+ * AA sort of [first, last) in Order with scratch space for only half the
+ * elements.
+ * the 2 halves are sorted with sort_range, the lower half is moved to temp
+ * and merged with the upper half into [first, last). the merge writes
+ * behind its reads of the upper half, so it can run in place.
+ * temp must hold (last - first + 1) / 2 elements.
+ */
+template <class Order = ascending, class RandomAccessIterator,
+          class TempIterator>
+inline void sort_range_half(RandomAccessIterator first,
+                            RandomAccessIterator last, TempIterator temp)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t lanes = sort_lanes<value_type>::value;
+
+    size_t elements = std::distance(first, last);
+    size_t lower = elements / 2;
+
+    sort_range<Order>(first, first + lower, temp);
+    sort_range<Order>(first + lower, last, temp);
+
+    FLOKI_SORT_PHASE("half merge");
+    std::copy(first, first + lower, temp);
+    merge_n<lanes, Order>(temp, lower, first + lower, elements - lower, first);
+}
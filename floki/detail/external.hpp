@@ -0,0 +1,240 @@
+#pragma once
+
+/**
+ * file opened with open(2), closed when it goes out of scope. errors throw
+ * std::system_error with the path in the message.
+ */
+class posix_file
+{
+public:
+    posix_file(const std::string &path, int flags)
+        : m_path(path), m_fd(::open(path.c_str(), flags, 0644))
+    {
+        if (m_fd < 0) {
+            fail("open");
+        }
+    }
+
+    posix_file(const posix_file &) = delete;
+    posix_file &operator=(const posix_file &) = delete;
+
+    ~posix_file() { ::close(m_fd); }
+
+    int fd() const { return m_fd; }
+
+    size_t size() const
+    {
+        struct stat st;
+        if (::fstat(m_fd, &st) != 0) {
+            fail("stat");
+        }
+        return static_cast<size_t>(st.st_size);
+    }
+
+    /**
+     * reads up to bytes bytes, fewer only at the end of the file.
+     */
+    size_t read(void *data, size_t bytes) const
+    {
+        char *p = static_cast<char *>(data);
+        size_t done = 0;
+        while (done < bytes) {
+            ssize_t n = ::read(m_fd, p + done, bytes - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                fail("read");
+            }
+            if (n == 0) {
+                break;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return done;
+    }
+
+    void write(const void *data, size_t bytes) const
+    {
+        const char *p = static_cast<const char *>(data);
+        while (bytes) {
+            ssize_t n = ::write(m_fd, p, bytes);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                fail("write");
+            }
+            p += n;
+            bytes -= static_cast<size_t>(n);
+        }
+    }
+
+private:
+    void fail(const char *what) const
+    {
+        throw std::system_error(errno, std::system_category(),
+                                std::string(what) + " " + m_path);
+    }
+
+    std::string m_path;
+    int m_fd;
+};
+
+/**
+ * read only mapping of a whole file.
+ */
+class mapped_file
+{
+public:
+    explicit mapped_file(const posix_file &file)
+        : m_bytes(file.size()), m_data(nullptr)
+    {
+        if (!m_bytes) {
+            return;
+        }
+        void *p = ::mmap(nullptr, m_bytes, PROT_READ, MAP_SHARED, file.fd(), 0);
+        if (p == MAP_FAILED) {
+            throw std::system_error(errno, std::system_category(), "mmap");
+        }
+        m_data = p;
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    ~mapped_file()
+    {
+        if (m_data) {
+            ::munmap(m_data, m_bytes);
+        }
+    }
+
+    const void *data() const { return m_data; }
+
+private:
+    size_t m_bytes;
+    void *m_data;
+};
+
+/**
+ * reads the input in runs of run_elements, sorts each run with floki::sort
+ * and writes it to runs. the next run is read on a second thread while the
+ * current one is sorted and written. returns the run bounds.
+ */
+template <typename T>
+inline std::vector<size_t> write_sorted_runs(const posix_file &input,
+                                             const posix_file &runs,
+                                             size_t run_elements)
+{
+    using vector_t = std::vector<T, boost::simd::allocator<T>>;
+
+    const size_t elements = input.size() / sizeof(T);
+
+    vector_t current(std::min(run_elements, elements));
+    vector_t next(current.size());
+    sort_workspace<T> workspace;
+
+    std::vector<size_t> bounds(1, 0);
+
+    size_t current_elements
+        = input.read(current.data(), current.size() * sizeof(T)) / sizeof(T);
+
+    while (current_elements) {
+        size_t next_elements = 0;
+        std::exception_ptr read_error;
+        std::thread reader([&] {
+            try {
+                next_elements
+                    = input.read(next.data(), next.size() * sizeof(T)) / sizeof(T);
+            } catch (...) {
+                read_error = std::current_exception();
+            }
+        });
+
+        try {
+            floki::sort(current.begin(), current.begin() + current_elements,
+                        workspace);
+            runs.write(current.data(), current_elements * sizeof(T));
+        } catch (...) {
+            reader.join();
+            throw;
+        }
+
+        reader.join();
+        if (read_error) {
+            std::rethrow_exception(read_error);
+        }
+
+        bounds.push_back(bounds.back() + current_elements);
+        current.swap(next);
+        current_elements = next_elements;
+    }
+
+    return bounds;
+}
+
+/**
+ * merges the sorted runs of a mapped file into output.
+ * the output is built in segments with multiway_split and merge_pieces, and
+ * each segment is written on a second thread while the next one is merged.
+ */
+template <typename T>
+inline void merge_runs_to_file(const T *data, const std::vector<size_t> &bounds,
+                               const posix_file &output, size_t segment)
+{
+    using vector_t = std::vector<T, boost::simd::allocator<T>>;
+
+    const size_t lanes = sort_lanes<T>::value;
+    const size_t runs = bounds.size() - 1;
+    const size_t elements = bounds.back();
+
+    vector_t buffer(segment), other_buffer(segment);
+    vector_t current(segment), writing(segment);
+
+    std::vector<size_t> piece_first(bounds.begin(), bounds.end() - 1);
+    std::vector<size_t> piece_last(runs);
+
+    std::thread writer;
+    std::exception_ptr write_error;
+
+    for (size_t rank = 0; rank < elements; rank += segment) {
+        size_t next_rank = std::min(rank + segment, elements);
+
+        try {
+            multiway_split(data, &bounds[0], runs, next_rank, &piece_last[0]);
+            merge_pieces<lanes>(data, piece_first, piece_last, current.begin(),
+                                buffer.begin(), other_buffer.begin());
+        } catch (...) {
+            if (writer.joinable()) {
+                writer.join();
+            }
+            throw;
+        }
+        piece_first.swap(piece_last);
+
+        if (writer.joinable()) {
+            writer.join();
+        }
+        if (write_error) {
+            std::rethrow_exception(write_error);
+        }
+
+        current.swap(writing);
+        size_t bytes = (next_rank - rank) * sizeof(T);
+        writer = std::thread([&, bytes] {
+            try {
+                output.write(writing.data(), bytes);
+            } catch (...) {
+                write_error = std::current_exception();
+            }
+        });
+    }
+
+    if (writer.joinable()) {
+        writer.join();
+    }
+    if (write_error) {
+        std::rethrow_exception(write_error);
+    }
+}
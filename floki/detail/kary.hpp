@@ -0,0 +1,217 @@
+#pragma once
+
+/**
+ * k to the power exponent, in integers.
+ */
+inline size_t kary_power(size_t k, size_t exponent)
+{
+    size_t power = 1;
+    while (exponent--) {
+        power *= k;
+    }
+    return power;
+}
+
+/**
+ * levels of the smallest complete k-ary tree with room for elements keys.
+ * a tree of L levels holds k^L - 1 keys.
+ */
+inline size_t kary_levels(size_t k, size_t elements)
+{
+    size_t levels = 0;
+    for (size_t capacity = 0; capacity < elements;
+         capacity = capacity * k + k - 1) {
+        ++levels;
+    }
+    return levels;
+}
+
+/**
+ * nodes stored for the last level of a tree of elements keys. node j of the
+ * last level holds sorted positions [j * k, j * k + k - 1), so the nodes past
+ * the last key hold only padding and are left out.
+ */
+inline size_t kary_last_level_nodes(size_t k, size_t elements)
+{
+    return (elements + k - 1) / k;
+}
+
+/**
+ * keys stored for a tree of elements keys. the levels above the last are
+ * complete, the last level ends at its last node holding a key.
+ */
+inline size_t kary_stored_keys(size_t k, size_t elements)
+{
+    const size_t levels = kary_levels(k, elements);
+    if (!levels) {
+        return 0;
+    }
+    return kary_power(k, levels - 1) - 1
+           + kary_last_level_nodes(k, elements) * (k - 1);
+}
+
+/**
+ * writes nodes [first_node, last_node) of a level of the breadth first k-ary
+ * tree of the sorted keys [first, first + elements) to out.
+ * a node of level l covers k^(levels - l) sorted positions with its subtree,
+ * key s of node j is at j * k^(levels - l) + (s + 1) * k^(levels - l - 1) - 1.
+ * positions past the keys are filled with padding, which must not be less
+ * than any key.
+ */
+template <typename RandomAccessIterator, typename OutputIterator, typename T>
+inline OutputIterator kary_linearize_level(RandomAccessIterator first,
+                                           size_t elements, size_t k,
+                                           size_t levels, size_t level,
+                                           size_t first_node, size_t last_node,
+                                           T padding, OutputIterator out)
+{
+    const size_t node_span = kary_power(k, levels - level);
+    const size_t key_span = node_span / k;
+
+    for (size_t node = first_node; node < last_node; ++node) {
+        size_t position = node * node_span + key_span - 1;
+        for (size_t key = 0; key < k - 1; ++key, position += key_span) {
+            *out++ = position < elements ? T(first[position]) : padding;
+        }
+    }
+    return out;
+}
+
+/**
+ * writes the breadth first k-ary tree of the sorted keys
+ * [first, first + elements) to out, kary_stored_keys values.
+ * every key is written once with integer arithmetic, level by level. with
+ * more than one thread every level is split into equal node ranges, one per
+ * thread, the levels do not depend on each other.
+ */
+template <typename RandomAccessIterator, typename OutputIterator, typename T>
+inline void kary_linearize(RandomAccessIterator first, size_t elements,
+                           size_t k, T padding, OutputIterator out,
+                           unsigned threads = 1)
+{
+    const size_t levels = kary_levels(k, elements);
+
+    threads = parallel_threads(elements, threads);
+
+    parallel_for(threads, [&](unsigned t) {
+        size_t level_begin = 0;
+        for (size_t level = 0; level < levels; ++level) {
+            const size_t nodes = level + 1 < levels
+                                     ? kary_power(k, level)
+                                     : kary_last_level_nodes(k, elements);
+            const size_t first_node = nodes * t / threads;
+            const size_t last_node = nodes * (t + 1) / threads;
+
+            kary_linearize_level(first, elements, k, levels, level,
+                                 first_node, last_node, padding,
+                                 out + (level_begin + first_node * (k - 1)));
+            level_begin += nodes * (k - 1);
+        }
+    });
+}
+
+/**
+ * breadth first search of a tree written by kary_linearize. returns the
+ * number of keys less than key, the position of std::lower_bound.
+ * a search that reaches a last level node that is not stored is past every
+ * key, the node would only hold padding.
+ */
+template <uint32_t k, typename T>
+inline size_t kary_search(const T *tree, size_t stored, size_t levels, T key)
+{
+    using std::placeholders::_1;
+
+    size_t position = 0;
+    size_t level_begin = 0;
+    size_t level_nodes = 1;
+
+    for (size_t level = 0; level < levels; ++level) {
+        const size_t node = level_begin + position * (k - 1);
+        position *= k;
+        if (node < stored) {
+            position += floki::find_if(tree + node, tree + node + (k - 1),
+                                       std::bind(floki::greater_equal(), _1,
+                                                 key)) - (tree + node);
+        }
+        level_begin += level_nodes * (k - 1);
+        level_nodes *= k;
+    }
+    return position;
+}
+
+/**
+ * lookups kary_search_batch moves through the tree together. the node of a
+ * lookup is prefetched kary_batch_group - 1 node searches before it is read,
+ * enough to cover a DRAM miss with nodes of one or two cache lines.
+ */
+const size_t kary_batch_group = 16;
+
+/**
+ * prefetches the cache lines of a node of keys keys.
+ */
+template <typename T> inline void prefetch_node(const T *node, size_t keys)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(node);
+    __builtin_prefetch(node + (keys - 1));
+#endif
+}
+
+/**
+ * kary_search of keys [keys, keys + n), results capped at limit and written
+ * to out.
+ * the lookups go through the tree in groups of kary_batch_group, one level
+ * at a time. each lookup prefetches its node of the next level as soon as it
+ * is known, and the node is read only after the rest of the group has
+ * searched the current level, so the misses of a group overlap instead of
+ * every level of every lookup waiting on its own miss.
+ */
+template <uint32_t k, typename T, typename OutputIterator>
+inline OutputIterator kary_search_batch(const T *tree, size_t stored,
+                                        size_t levels, size_t limit,
+                                        const T *keys, size_t n,
+                                        OutputIterator out)
+{
+    using std::placeholders::_1;
+
+    size_t position[kary_batch_group];
+
+    for (size_t first = 0; first < n; first += kary_batch_group) {
+        const size_t group = std::min(kary_batch_group, n - first);
+        const T *group_keys = keys + first;
+
+        std::fill(position, position + group, size_t(0));
+
+        size_t level_begin = 0;
+        size_t level_nodes = 1;
+
+        for (size_t level = 0; level < levels; ++level) {
+            const size_t next_begin = level_begin + level_nodes * (k - 1);
+            const bool prefetch = level + 1 < levels;
+
+            for (size_t i = 0; i < group; ++i) {
+                const size_t node = level_begin + position[i] * (k - 1);
+                position[i] *= k;
+                if (node < stored) {
+                    position[i] += floki::find_if(
+                        tree + node, tree + node + (k - 1),
+                        std::bind(floki::greater_equal(), _1,
+                                  group_keys[i])) - (tree + node);
+                }
+
+                const size_t next = next_begin + position[i] * (k - 1);
+                if (prefetch && next < stored) {
+                    prefetch_node(tree + next, k - 1);
+                }
+            }
+
+            level_begin = next_begin;
+            level_nodes *= k;
+        }
+
+        for (size_t i = 0; i < group; ++i) {
+            *out++ = std::min(position[i], limit);
+        }
+    }
+    return out;
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+/**
+ * a vector of keys and the vector of values that travel with them.
+ * the sorting networks only touch their vectors through minmax, shuffle,
+ * interleave_first, interleave_second and reverse. overloading those for
+ * key_value runs the values through exactly the same steps as the keys.
+ * values are kept bitwise cast to the key type, so keys and values must have
+ * the same size.
+ */
+template <typename simd_type> struct key_value
+{
+    using value_type = typename simd_type::value_type;
+    static const size_t static_size = simd_type::static_size;
+
+    simd_type key;
+    simd_type value;
+};
+
+template <typename simd_type>
+inline key_value<simd_type> make_key_value(simd_type key, simd_type value)
+{
+    key_value<simd_type> kv;
+    kv.key = key;
+    kv.value = value;
+    return kv;
+}
+
+/**
+ * key value minmax
+ * the keys are ordered as in minmax and each value follows its key.
+ */
+template <typename simd_type>
+inline tuple<key_value<simd_type>, key_value<simd_type>>
+minmax(key_value<simd_type> a, key_value<simd_type> b)
+{
+    using boost::simd::if_else;
+
+    auto swap = boost::simd::is_less(b.key, a.key);
+
+    return make_tuple(
+        make_key_value(if_else(swap, b.key, a.key),
+                       if_else(swap, b.value, a.value)),
+        make_key_value(if_else(swap, a.key, b.key),
+                       if_else(swap, a.value, b.value)));
+}
+
+template <int... indices, typename simd_type>
+inline key_value<simd_type> shuffle(key_value<simd_type> a)
+{
+    return make_key_value(boost::simd::shuffle<indices...>(a.key),
+                          boost::simd::shuffle<indices...>(a.value));
+}
+
+template <int... indices, typename simd_type>
+inline key_value<simd_type> shuffle(key_value<simd_type> a,
+                                    key_value<simd_type> b)
+{
+    return make_key_value(boost::simd::shuffle<indices...>(a.key, b.key),
+                          boost::simd::shuffle<indices...>(a.value, b.value));
+}
+
+template <typename simd_type>
+inline key_value<simd_type> interleave_first(key_value<simd_type> a,
+                                             key_value<simd_type> b)
+{
+    return make_key_value(boost::simd::interleave_first(a.key, b.key),
+                          boost::simd::interleave_first(a.value, b.value));
+}
+
+template <typename simd_type>
+inline key_value<simd_type> interleave_second(key_value<simd_type> a,
+                                              key_value<simd_type> b)
+{
+    return make_key_value(boost::simd::interleave_second(a.key, b.key),
+                          boost::simd::interleave_second(a.value, b.value));
+}
+
+template <typename simd_type>
+inline key_value<simd_type> reverse(key_value<simd_type> a)
+{
+    return make_key_value(boost::simd::reverse(a.key),
+                          boost::simd::reverse(a.value));
+}
+
+/**
+ * reads a key vector and a value vector in lockstep.
+ * base() is the underlying key iterator, so merge_sort compares keys.
+ */
+template <typename KeyIterator, typename ValueIterator>
+class key_value_input_iterator
+{
+public:
+    using key_simd_type = typename KeyIterator::value_type;
+    using value_type = key_value<key_simd_type>;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+    using pointer = void;
+    using reference = value_type;
+
+    key_value_input_iterator(KeyIterator keys, ValueIterator values)
+        : m_keys(keys), m_values(values)
+    {
+    }
+
+    value_type operator*() const
+    {
+        return make_key_value(*m_keys,
+                              boost::simd::bitwise_cast<key_simd_type>(*m_values));
+    }
+
+    auto base() const -> decltype(std::declval<KeyIterator>().base())
+    {
+        return m_keys.base();
+    }
+
+    key_value_input_iterator &operator++()
+    {
+        ++m_keys;
+        ++m_values;
+        return *this;
+    }
+
+    key_value_input_iterator operator++(int)
+    {
+        key_value_input_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    key_value_input_iterator operator+(difference_type n) const
+    {
+        return key_value_input_iterator(m_keys + n, m_values + n);
+    }
+
+    difference_type operator-(const key_value_input_iterator &other) const
+    {
+        return m_keys - other.m_keys;
+    }
+
+    bool operator==(const key_value_input_iterator &other) const
+    {
+        return m_keys == other.m_keys;
+    }
+
+    bool operator!=(const key_value_input_iterator &other) const
+    {
+        return m_keys != other.m_keys;
+    }
+
+    bool operator<(const key_value_input_iterator &other) const
+    {
+        return m_keys < other.m_keys;
+    }
+
+private:
+    KeyIterator m_keys;
+    ValueIterator m_values;
+};
+
+/**
+ * writes a key vector and a value vector in lockstep.
+ */
+template <typename KeyIterator, typename ValueIterator>
+class key_value_output_iterator
+{
+public:
+    using value_simd_type = typename ValueIterator::value_type;
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::output_iterator_tag;
+    using pointer = void;
+
+    class reference
+    {
+    public:
+        reference(KeyIterator keys, ValueIterator values)
+            : m_keys(keys), m_values(values)
+        {
+        }
+
+        template <typename simd_type>
+        reference &operator=(const key_value<simd_type> &kv)
+        {
+            *m_keys = kv.key;
+            *m_values = boost::simd::bitwise_cast<value_simd_type>(kv.value);
+            return *this;
+        }
+
+    private:
+        KeyIterator m_keys;
+        ValueIterator m_values;
+    };
+
+    key_value_output_iterator(KeyIterator keys, ValueIterator values)
+        : m_keys(keys), m_values(values)
+    {
+    }
+
+    reference operator*() const { return reference(m_keys, m_values); }
+
+    key_value_output_iterator &operator++()
+    {
+        ++m_keys;
+        ++m_values;
+        return *this;
+    }
+
+    key_value_output_iterator operator++(int)
+    {
+        key_value_output_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    key_value_output_iterator operator+(difference_type n) const
+    {
+        return key_value_output_iterator(m_keys + n, m_values + n);
+    }
+
+private:
+    KeyIterator m_keys;
+    ValueIterator m_values;
+};
+
+template <typename KeyIterator, typename ValueIterator>
+inline key_value_input_iterator<KeyIterator, ValueIterator>
+key_value_input(KeyIterator keys, ValueIterator values)
+{
+    return key_value_input_iterator<KeyIterator, ValueIterator>(keys, values);
+}
+
+template <typename KeyIterator, typename ValueIterator>
+inline key_value_output_iterator<KeyIterator, ValueIterator>
+key_value_output(KeyIterator keys, ValueIterator values)
+{
+    return key_value_output_iterator<KeyIterator, ValueIterator>(keys, values);
+}
+
+/**
+ * finishes a key value sort where the last tail elements are not part of a
+ * sort block. the tail is insertion sorted and merged with the sorted
+ * front through temp. front elements below the smallest tail key are already
+ * in place and are skipped.
+ */
+template <typename KeyIterator, typename ValueIterator, typename KeyTemp,
+          typename ValueTemp>
+inline void merge_tail_by_key(KeyIterator keys, ValueIterator values,
+                              size_t elements, size_t tail, KeyTemp key_temp,
+                              ValueTemp value_temp)
+{
+    const size_t front = elements - tail;
+
+    for (size_t i = front + 1; i < elements; ++i) {
+        auto key = keys[i];
+        auto value = values[i];
+        size_t j = i;
+        for (; j > front && key < keys[j - 1]; --j) {
+            keys[j] = keys[j - 1];
+            values[j] = values[j - 1];
+        }
+        keys[j] = key;
+        values[j] = value;
+    }
+
+    size_t a = std::upper_bound(keys, keys + front, keys[front]) - keys;
+    size_t b = front;
+    size_t first = a;
+    size_t out = 0;
+
+    while (a < front && b < elements) {
+        if (keys[b] < keys[a]) {
+            key_temp[out] = keys[b];
+            value_temp[out++] = values[b++];
+        } else {
+            key_temp[out] = keys[a];
+            value_temp[out++] = values[a++];
+        }
+    }
+    for (; a < front; ++a, ++out) {
+        key_temp[out] = keys[a];
+        value_temp[out] = values[a];
+    }
+    for (; b < elements; ++b, ++out) {
+        key_temp[out] = keys[b];
+        value_temp[out] = values[b];
+    }
+
+    std::copy(key_temp, key_temp + out, keys + first);
+    std::copy(value_temp, value_temp + out, values + first);
+}
+
+/**
+ * index type carried as the value when sorting keys of type key_type by key.
+ */
+template <typename key_type> struct index_of;
+
+template <> struct index_of<int32_t> { using type = uint32_t; };
+template <> struct index_of<uint32_t> { using type = uint32_t; };
+template <> struct index_of<float> { using type = uint32_t; };
+template <> struct index_of<int64_t> { using type = uint64_t; };
+template <> struct index_of<uint64_t> { using type = uint64_t; };
+template <> struct index_of<double> { using type = uint64_t; };
+
+inline std::vector<uint32_t> to_indices(std::vector<uint32_t> &&indices)
+{
+    return std::move(indices);
+}
+
+inline std::vector<uint32_t> to_indices(std::vector<uint64_t> &&indices)
+{
+    return std::vector<uint32_t>(begin(indices), end(indices));
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+/**
+ * bytes of cache a multiway sort works in. chunks of half this size are
+ * sorted with their scratch space in cache, and multiway merges build their
+ * output in segments of half this size.
+ */
+const size_t multiway_cache_bytes = 512 * 1024;
+
+/**
+ * sorted runs merged by one multiway merge pass.
+ */
+const size_t multiway_ways = 64;
+
+/**
+ * multisequence selection
+ * finds split points in the runs [bounds[i], bounds[i + 1]) of data so that
+ * the elements before the splits are the rank smallest elements of all runs.
+ * splits are absolute indices into data.
+ *
+ * each step takes the middle of the widest search window as a pivot and
+ * narrows every window by its rank, until the pivot's equal range covers
+ * rank.
+ */
+template <typename InputIterator>
+inline void multiway_split(InputIterator data, const size_t *bounds,
+                           size_t runs, size_t rank, size_t *splits)
+{
+    std::vector<size_t> lo(bounds, bounds + runs);
+    std::vector<size_t> hi(bounds + 1, bounds + runs + 1);
+    std::vector<size_t> below(runs), not_above(runs);
+
+    for (;;) {
+        size_t widest = 0;
+        for (size_t i = 1; i < runs; ++i) {
+            if (hi[i] - lo[i] > hi[widest] - lo[widest]) {
+                widest = i;
+            }
+        }
+        if (hi[widest] == lo[widest]) {
+            break;
+        }
+
+        auto pivot = data[lo[widest] + (hi[widest] - lo[widest]) / 2];
+
+        size_t below_count = 0;
+        size_t not_above_count = 0;
+        for (size_t i = 0; i < runs; ++i) {
+            below[i] = std::lower_bound(data + lo[i], data + hi[i], pivot) - data;
+            not_above[i]
+                = std::upper_bound(data + below[i], data + hi[i], pivot) - data;
+            below_count += below[i] - bounds[i];
+            not_above_count += not_above[i] - bounds[i];
+        }
+
+        if (below_count > rank) {
+            hi.swap(below);
+        } else if (not_above_count < rank) {
+            lo.swap(not_above);
+        } else {
+            // elements equal to the pivot fill up the rank
+            size_t needed = rank - below_count;
+            for (size_t i = 0; i < runs; ++i) {
+                size_t taken = std::min(needed, not_above[i] - below[i]);
+                splits[i] = below[i] + taken;
+                needed -= taken;
+            }
+            return;
+        }
+    }
+
+    std::copy(begin(lo), end(lo), splits);
+}
+
+/**
+ * merges the sorted pieces [piece_first[i], piece_last[i]) of data into
+ * dest. the pieces are merged pairwise, a tree of merge_n kernels, through 2
+ * cache resident buffers that each hold all pieces. only the first round
+ * reads data and only the last round writes dest.
+ */
+template <size_t lanes, typename InputIterator, typename OutputIterator,
+          typename BufferIterator>
+inline void merge_pieces(InputIterator data,
+                         const std::vector<size_t> &piece_first,
+                         const std::vector<size_t> &piece_last,
+                         OutputIterator dest, BufferIterator buffer,
+                         BufferIterator other_buffer)
+{
+    const size_t pieces = piece_first.size();
+
+    if (pieces == 1) {
+        std::copy(data + piece_first[0], data + piece_last[0], dest);
+        return;
+    }
+    if (pieces == 2) {
+        merge_n<lanes>(data + piece_first[0], piece_last[0] - piece_first[0],
+                       data + piece_first[1], piece_last[1] - piece_first[1],
+                       dest);
+        return;
+    }
+
+    // first round, data to buffer
+    std::vector<size_t> bounds(1, 0);
+    for (size_t i = 0; i < pieces; i += 2) {
+        size_t a_elements = piece_last[i] - piece_first[i];
+        size_t b_elements
+            = i + 1 < pieces ? piece_last[i + 1] - piece_first[i + 1] : 0;
+        merge_n<lanes>(data + piece_first[i], a_elements,
+                       data + piece_first[i + (b_elements ? 1 : 0)],
+                       b_elements, buffer + bounds.back());
+        bounds.push_back(bounds.back() + a_elements + b_elements);
+    }
+
+    // middle rounds, buffer to buffer
+    while (bounds.size() > 3) {
+        std::vector<size_t> merged(1, 0);
+        for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            size_t middle = bounds[r + 1];
+            size_t last = r + 2 < bounds.size() ? bounds[r + 2] : middle;
+            merge_n<lanes>(buffer + bounds[r], middle - bounds[r],
+                           buffer + middle, last - middle,
+                           other_buffer + bounds[r]);
+            merged.push_back(last);
+        }
+        bounds.swap(merged);
+        std::swap(buffer, other_buffer);
+    }
+
+    // last round, buffer to dest
+    merge_n<lanes>(buffer, bounds[1], buffer + bounds[1], bounds[2] - bounds[1],
+                   dest);
+}
+
+/**
+ * merges each group of ways adjacent sorted runs of input into one run of
+ * output. run i is [bounds[i], bounds[i + 1]). the output of a group is built
+ * in segments of segment elements, each split off the runs with
+ * multiway_split and merged in cache with merge_pieces, so input and output
+ * are streamed through memory once.
+ */
+template <size_t lanes, typename InputIterator, typename OutputIterator,
+          typename BufferIterator>
+inline void multiway_merge_pass(InputIterator input, OutputIterator output,
+                                const std::vector<size_t> &bounds, size_t ways,
+                                size_t segment, BufferIterator buffer,
+                                BufferIterator other_buffer)
+{
+    for (size_t group = 0; group + 1 < bounds.size(); group += ways) {
+        size_t runs = std::min(ways, bounds.size() - 1 - group);
+        const size_t *group_bounds = &bounds[group];
+        size_t group_elements = group_bounds[runs] - group_bounds[0];
+
+        std::vector<size_t> piece_first(group_bounds, group_bounds + runs);
+        std::vector<size_t> piece_last(runs);
+
+        for (size_t rank = 0; rank < group_elements; rank += segment) {
+            size_t next_rank = std::min(rank + segment, group_elements);
+
+            multiway_split(input, group_bounds, runs, next_rank, &piece_last[0]);
+            merge_pieces<lanes>(input, piece_first, piece_last,
+                                output + (group_bounds[0] + rank), buffer,
+                                other_buffer);
+            piece_first.swap(piece_last);
+        }
+    }
+}
+
+/**
+ * cache aware AA sort.
+ * sorts chunk elements at a time while they are in cache, then merges ways
+ * runs per pass with multiway_merge_pass, so the data goes through memory
+ * 1 + log_ways(elements / chunk) times instead of log2(elements / 16) times.
+ * the chunks are sorted in place or into temp, whichever makes the last merge
+ * pass end in [first, last).
+ */
+template <class RandomAccessIterator>
+inline void multiway_sort(RandomAccessIterator first, RandomAccessIterator last,
+                          size_t chunk, size_t ways, size_t segment)
+{
+    using boost::simd::allocator;
+
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    using vector_t = std::vector<value_type, allocator<value_type>>;
+
+    const size_t lanes = sort_lanes<value_type>::value;
+    const size_t elements = std::distance(first, last);
+
+    std::vector<size_t> bounds;
+    for (size_t begin = 0; begin < elements; begin += chunk) {
+        bounds.push_back(begin);
+    }
+    bounds.push_back(elements);
+
+    size_t passes = 0;
+    for (size_t runs = bounds.size() - 1; runs > 1;
+         runs = (runs + ways - 1) / ways) {
+        ++passes;
+    }
+
+    vector_t temp(elements);
+    vector_t chunk_temp(std::min(chunk, elements));
+    vector_t buffer(segment);
+    vector_t other_buffer(segment);
+
+    bool in_temp = passes % 2 == 1;
+
+    for (size_t r = 0; r + 1 < bounds.size(); ++r) {
+        if (in_temp) {
+            auto chunk_first = temp.begin() + bounds[r];
+            auto chunk_last = temp.begin() + bounds[r + 1];
+            std::copy(first + bounds[r], first + bounds[r + 1], chunk_first);
+            sort_range(chunk_first, chunk_last, begin(chunk_temp));
+        } else {
+            sort_range(first + bounds[r], first + bounds[r + 1],
+                       begin(chunk_temp));
+        }
+    }
+
+    while (bounds.size() > 2) {
+        if (in_temp) {
+            multiway_merge_pass<lanes>(begin(temp), first, bounds, ways,
+                                       segment, begin(buffer),
+                                       begin(other_buffer));
+        } else {
+            multiway_merge_pass<lanes>(first, begin(temp), bounds, ways,
+                                       segment, begin(buffer),
+                                       begin(other_buffer));
+        }
+        in_temp = !in_temp;
+
+        std::vector<size_t> merged;
+        for (size_t r = 0; r + 1 < bounds.size(); r += ways) {
+            merged.push_back(bounds[r]);
+        }
+        merged.push_back(elements);
+        bounds.swap(merged);
+    }
+}
@@ -0,0 +1,253 @@
+#pragma once
+
+/**
+ * a vector sorted in Order rather than ascending.
+ * like key_value, the sorting networks only touch it through minmax,
+ * shuffle, interleave_first, interleave_second and reverse, and only minmax
+ * depends on the order. the order is part of the type, so it is resolved at
+ * compile time.
+ */
+template <typename simd_type, typename Order> struct ordered
+{
+    using value_type = typename simd_type::value_type;
+    static const size_t static_size = simd_type::static_size;
+
+    ordered() {}
+    explicit ordered(simd_type v) : value(v) {}
+
+    simd_type value;
+};
+
+/**
+ * order a vector type is sorted in.
+ */
+template <typename simd_type> struct order_of
+{
+    using type = ascending;
+};
+
+template <typename simd_type, typename Order>
+struct order_of<ordered<simd_type, Order>>
+{
+    using type = Order;
+};
+
+/**
+ * vector type that sorts simd_type in Order. ascending vectors are not
+ * wrapped, so the ascending sort compiles to the same code as before.
+ */
+template <typename simd_type, typename Order> struct ordered_type
+{
+    using type = ordered<simd_type, Order>;
+};
+
+template <typename simd_type> struct ordered_type<simd_type, ascending>
+{
+    using type = simd_type;
+};
+
+template <typename simd_type> inline simd_type unordered(simd_type a)
+{
+    return a;
+}
+
+template <typename simd_type, typename Order>
+inline simd_type unordered(ordered<simd_type, Order> a)
+{
+    return a.value;
+}
+
+template <typename simd_type, typename Order>
+inline boost::tuples::tuple<ordered<simd_type, Order>, ordered<simd_type, Order>>
+minmax(ordered<simd_type, Order> a, ordered<simd_type, Order> b)
+{
+    simd_type lo, hi;
+    boost::tuples::tie(lo, hi) = Order::minmax(a.value, b.value);
+    return boost::tuples::make_tuple(ordered<simd_type, Order>(lo),
+                                     ordered<simd_type, Order>(hi));
+}
+
+template <int... indices, typename simd_type, typename Order>
+inline ordered<simd_type, Order> shuffle(ordered<simd_type, Order> a)
+{
+    return ordered<simd_type, Order>(boost::simd::shuffle<indices...>(a.value));
+}
+
+template <int... indices, typename simd_type, typename Order>
+inline ordered<simd_type, Order> shuffle(ordered<simd_type, Order> a,
+                                         ordered<simd_type, Order> b)
+{
+    return ordered<simd_type, Order>(
+        boost::simd::shuffle<indices...>(a.value, b.value));
+}
+
+template <typename simd_type, typename Order>
+inline ordered<simd_type, Order> interleave_first(ordered<simd_type, Order> a,
+                                                  ordered<simd_type, Order> b)
+{
+    return ordered<simd_type, Order>(
+        boost::simd::interleave_first(a.value, b.value));
+}
+
+template <typename simd_type, typename Order>
+inline ordered<simd_type, Order> interleave_second(ordered<simd_type, Order> a,
+                                                   ordered<simd_type, Order> b)
+{
+    return ordered<simd_type, Order>(
+        boost::simd::interleave_second(a.value, b.value));
+}
+
+template <typename simd_type, typename Order>
+inline ordered<simd_type, Order> reverse(ordered<simd_type, Order> a)
+{
+    return ordered<simd_type, Order>(boost::simd::reverse(a.value));
+}
+
+/**
+ * reads vectors of an input vector iterator as ordered vectors.
+ * base() is the underlying scalar iterator, for the merge_sort selection.
+ */
+template <typename Iterator, typename Order> class ordered_input_iterator
+{
+public:
+    using value_type = ordered<typename Iterator::value_type, Order>;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+    using pointer = void;
+    using reference = value_type;
+
+    explicit ordered_input_iterator(Iterator it) : m_it(it) {}
+
+    value_type operator*() const { return value_type(*m_it); }
+
+    auto base() const -> decltype(std::declval<Iterator>().base())
+    {
+        return m_it.base();
+    }
+
+    ordered_input_iterator &operator++()
+    {
+        ++m_it;
+        return *this;
+    }
+
+    ordered_input_iterator operator++(int)
+    {
+        ordered_input_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    ordered_input_iterator operator+(difference_type n) const
+    {
+        return ordered_input_iterator(m_it + n);
+    }
+
+    difference_type operator-(const ordered_input_iterator &other) const
+    {
+        return m_it - other.m_it;
+    }
+
+    bool operator==(const ordered_input_iterator &other) const
+    {
+        return m_it == other.m_it;
+    }
+
+    bool operator!=(const ordered_input_iterator &other) const
+    {
+        return m_it != other.m_it;
+    }
+
+    bool operator<(const ordered_input_iterator &other) const
+    {
+        return m_it < other.m_it;
+    }
+
+private:
+    Iterator m_it;
+};
+
+/**
+ * writes ordered vectors to an output vector iterator.
+ */
+template <typename Iterator, typename Order> class ordered_output_iterator
+{
+public:
+    using value_type = void;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::output_iterator_tag;
+    using pointer = void;
+
+    class reference
+    {
+    public:
+        explicit reference(Iterator it) : m_it(it) {}
+
+        template <typename simd_type>
+        reference &operator=(const ordered<simd_type, Order> &v)
+        {
+            *m_it = v.value;
+            return *this;
+        }
+
+    private:
+        Iterator m_it;
+    };
+
+    explicit ordered_output_iterator(Iterator it) : m_it(it) {}
+
+    reference operator*() const { return reference(m_it); }
+
+    ordered_output_iterator &operator++()
+    {
+        ++m_it;
+        return *this;
+    }
+
+    ordered_output_iterator operator++(int)
+    {
+        ordered_output_iterator it = *this;
+        ++*this;
+        return it;
+    }
+
+    ordered_output_iterator operator+(difference_type n) const
+    {
+        return ordered_output_iterator(m_it + n);
+    }
+
+private:
+    Iterator m_it;
+};
+
+/**
+ * views vector iterators as iterators over vectors sorted in Order.
+ * ascending iterators are returned as they are.
+ */
+template <typename Order> struct order_view
+{
+    template <typename Iterator>
+    static ordered_input_iterator<Iterator, Order> input(Iterator it)
+    {
+        return ordered_input_iterator<Iterator, Order>(it);
+    }
+
+    template <typename Iterator>
+    static ordered_output_iterator<Iterator, Order> output(Iterator it)
+    {
+        return ordered_output_iterator<Iterator, Order>(it);
+    }
+};
+
+template <> struct order_view<ascending>
+{
+    template <typename Iterator> static Iterator input(Iterator it)
+    {
+        return it;
+    }
+
+    template <typename Iterator> static Iterator output(Iterator it)
+    {
+        return it;
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * start of part t when elements are split into parts equal parts.
+ * split points are rounded down to a multiple of 256, the largest sort block
+ * (16 lanes of 16 vectors), so that every part but the last is made of whole
+ * sort blocks.
+ */
+inline size_t split_point(size_t elements, unsigned parts, unsigned t)
+{
+    if (t >= parts) {
+        return elements;
+    }
+    return (elements * t / parts) & ~size_t(255);
+}
+
+/**
+ * merge path partition
+ * returns the number of elements taken from a when the first diagonal
+ * elements of the merge of a and b, sorted in Order, are written.
+ * Odeh et al. Merge Path - Parallel Merging Made Simple.
+ */
+template <typename Order = ascending, typename InputIterator1,
+          typename InputIterator2>
+inline size_t merge_path(InputIterator1 a, size_t a_elements,
+                         InputIterator2 b, size_t b_elements, size_t diagonal)
+{
+    size_t lo = diagonal > b_elements ? diagonal - b_elements : 0;
+    size_t hi = std::min(diagonal, a_elements);
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (Order::less(b[diagonal - mid - 1], a[mid])) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+/**
+ * merges elements [first, last) of the merge of a and b into dest.
+ * dest points to the start of the whole merge.
+ */
+template <size_t lanes, typename Order = ascending, typename InputIterator1,
+          typename InputIterator2, typename OutputIterator>
+inline void merge_range(InputIterator1 a, size_t a_elements, InputIterator2 b,
+                        size_t b_elements, OutputIterator dest, size_t first,
+                        size_t last)
+{
+    size_t a_first = merge_path<Order>(a, a_elements, b, b_elements, first);
+    size_t a_last = merge_path<Order>(a, a_elements, b, b_elements, last);
+    size_t b_first = first - a_first;
+    size_t b_last = last - a_last;
+
+    merge_n<lanes, Order>(a + a_first, a_last - a_first, b + b_first,
+                          b_last - b_first, dest + first);
+}
+
+/**
+ * merges a and b into dest on threads threads, each writing an equal part of
+ * the output.
+ */
+template <size_t lanes, typename Order = ascending, typename InputIterator1,
+          typename InputIterator2, typename OutputIterator>
+inline void parallel_merge(InputIterator1 a, size_t a_elements,
+                           InputIterator2 b, size_t b_elements,
+                           OutputIterator dest, unsigned threads)
+{
+    const size_t elements = a_elements + b_elements;
+
+    parallel_for(threads, [&](unsigned t) {
+        merge_range<lanes, Order>(a, a_elements, b, b_elements, dest,
+                                  split_point(elements, threads, t),
+                                  split_point(elements, threads, t + 1));
+    });
+}
+
+/**
+ * merges adjacent pairs of sorted runs from input to output.
+ * run i is [bounds[i], bounds[i + 1]). the output is split into equal parts
+ * along merge path diagonals, so every thread gets the same amount of work no
+ * matter how few runs are left. an unpaired last run is copied.
+ */
+template <size_t lanes, typename InputIterator, typename OutputIterator>
+inline void parallel_merge_pass(InputIterator input, OutputIterator output,
+                                const std::vector<size_t> &bounds,
+                                unsigned threads)
+{
+    const size_t elements = bounds.back();
+
+    parallel_for(threads, [&](unsigned t) {
+        size_t begin = split_point(elements, threads, t);
+        size_t end = split_point(elements, threads, t + 1);
+
+        for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            size_t run_first = bounds[r];
+            size_t run_middle = bounds[r + 1];
+            size_t run_last = r + 2 < bounds.size() ? bounds[r + 2] : run_middle;
+
+            if (run_first >= end) {
+                break;
+            }
+            if (run_last <= begin) {
+                continue;
+            }
+
+            merge_range<lanes>(input + run_first, run_middle - run_first,
+                               input + run_middle, run_last - run_middle,
+                               output + run_first,
+                               std::max(begin, run_first) - run_first,
+                               std::min(end, run_last) - run_first);
+        }
+    });
+}
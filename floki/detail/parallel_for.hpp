@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+ * inputs smaller than this are not worth splitting across threads.
+ */
+const size_t parallel_grain = 64 * 1024;
+
+/**
+ * runs body(t) for t in [0, threads), each call on its own thread.
+ * call 0 runs on the calling thread.
+ */
+template <typename Function>
+inline void parallel_for(unsigned threads, Function body)
+{
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; ++t) {
+        pool.emplace_back(body, t);
+    }
+    body(0u);
+    for (auto &thread : pool) {
+        thread.join();
+    }
+}
+
+/**
+ * threads worth using for elements, at least parallel_grain elements each.
+ */
+inline unsigned parallel_threads(size_t elements, unsigned threads)
+{
+    return static_cast<unsigned>(std::max<size_t>(
+        1, std::min<size_t>(threads, elements / parallel_grain)));
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+/**
+ * maps the bits of a key to an unsigned key that sorts in the same order.
+ * unsigned keys are used as is, signed keys get their sign bit flipped and
+ * floating point keys all bits flipped when negative, the sign bit
+ * otherwise. encode works on a scalar key or a vector of keys.
+ */
+template <typename T, typename Enable = void> struct radix_traits;
+
+template <typename T>
+struct radix_traits<T, typename std::enable_if
+                   <std::is_integral<T>::value && std::is_unsigned<T>::value>::type>
+{
+    typedef T key_type;
+
+    template <typename K> static K encode(K k) { return k; }
+};
+
+template <typename T>
+struct radix_traits<T, typename std::enable_if
+                   <std::is_integral<T>::value && std::is_signed<T>::value>::type>
+{
+    typedef typename std::make_unsigned<T>::type key_type;
+
+    template <typename K> static K encode(K k)
+    {
+        const key_type sign = key_type(1) << (8 * sizeof(T) - 1);
+        return static_cast<K>(k ^ boost::simd::splat<K>(sign));
+    }
+};
+
+template <typename T>
+struct radix_traits<T, typename std::enable_if
+                   <std::is_floating_point<T>::value>::type>
+{
+    typedef typename std::conditional
+        <sizeof(T) == 4, uint32_t, uint64_t>::type key_type;
+
+    template <typename K> static K encode(K k)
+    {
+        const key_type sign = key_type(1) << (8 * sizeof(T) - 1);
+        K negative = static_cast<K>(-(k >> (8 * sizeof(T) - 1)));
+        return static_cast<K>(k ^ (negative | boost::simd::splat<K>(sign)));
+    }
+};
+
+/**
+ * sorted order key of a value.
+ */
+template <typename T>
+inline typename radix_traits<T>::key_type radix_key(T value)
+{
+    typedef typename radix_traits<T>::key_type key_type;
+    return radix_traits<T>::encode(boost::simd::bitwise_cast<key_type>(value));
+}
+
+const size_t radix_bits = 8;
+const size_t radix_buckets = 1 << radix_bits;
+
+/**
+ * counts the digits of all radix passes in one read pass. counts[d][b] is
+ * the number of keys with digit d equal to b.
+ * the keys are loaded and encoded a vector at a time.
+ */
+template <typename InputIterator>
+inline void radix_histogram(InputIterator first, size_t elements,
+                            size_t (*counts)[radix_buckets])
+{
+    FLOKI_SORT_PHASE("radix histogram");
+
+    using boost::simd::input_begin;
+    using value_type = typename std::iterator_traits<InputIterator>::value_type;
+    using traits = radix_traits<value_type>;
+    using key_type = typename traits::key_type;
+
+    const size_t lanes
+        = boost::simd::native<value_type, BOOST_SIMD_DEFAULT_EXTENSION>::static_size;
+    using simd_type_t = boost::simd::pack<value_type, lanes>;
+    using simd_key_t = boost::simd::pack<key_type, lanes>;
+
+    const size_t digits = sizeof(value_type);
+    size_t vector_elements = elements - elements % lanes;
+
+    auto in = input_begin<lanes>(first);
+    for (size_t i = 0; i < vector_elements; i += lanes, ++in) {
+        simd_key_t keys = traits::encode(
+            boost::simd::bitwise_cast<simd_key_t>(simd_type_t(*in)));
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            key_type key = keys[lane];
+            for (size_t d = 0; d < digits; ++d) {
+                ++counts[d][(key >> (d * radix_bits)) & (radix_buckets - 1)];
+            }
+        }
+    }
+
+    for (size_t i = vector_elements; i < elements; ++i) {
+        key_type key = radix_key(first[i]);
+        for (size_t d = 0; d < digits; ++d) {
+            ++counts[d][(key >> (d * radix_bits)) & (radix_buckets - 1)];
+        }
+    }
+}
+
+/**
+ * moves the elements of input to output ordered by the digit at shift,
+ * keeping the order of equal digits. offsets[b] is where the next element
+ * with digit b goes.
+ * elements are collected in a cache line sized buffer per bucket and written
+ * out a full line at a time, so the scatter writes whole cache lines instead
+ * of touching 256 lines at random.
+ */
+template <typename InputIterator, typename OutputIterator>
+inline void radix_scatter(InputIterator input, size_t elements,
+                          OutputIterator output, size_t *offsets, size_t shift)
+{
+    FLOKI_SORT_PHASE("radix pass");
+
+    using value_type = typename std::iterator_traits<InputIterator>::value_type;
+
+    const size_t line_elements = 64 / sizeof(value_type);
+
+    alignas(64) value_type lines[radix_buckets][line_elements];
+    size_t fill[radix_buckets] = {};
+
+    for (size_t i = 0; i < elements; ++i) {
+        value_type value = input[i];
+        size_t bucket = (radix_key(value) >> shift) & (radix_buckets - 1);
+
+        lines[bucket][fill[bucket]++] = value;
+        if (fill[bucket] == line_elements) {
+            std::copy(lines[bucket], lines[bucket] + line_elements,
+                      output + offsets[bucket]);
+            offsets[bucket] += line_elements;
+            fill[bucket] = 0;
+        }
+    }
+
+    for (size_t bucket = 0; bucket < radix_buckets; ++bucket) {
+        std::copy(lines[bucket], lines[bucket] + fill[bucket],
+                  output + offsets[bucket]);
+    }
+}
+
+/**
+ * LSD radix sort of [first, last) with 8 bit digits. passes alternate between
+ * data and temp and passes where all keys have the same digit are skipped.
+ * temp must hold last - first elements.
+ */
+template <class RandomAccessIterator, class TempIterator>
+inline void radix_sort_range(RandomAccessIterator first,
+                             RandomAccessIterator last, TempIterator temp)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t digits = sizeof(value_type);
+    const size_t elements = std::distance(first, last);
+
+    size_t counts[digits][radix_buckets] = {};
+    radix_histogram(first, elements, counts);
+
+    bool in_temp = false;
+
+    for (size_t d = 0; d < digits; ++d) {
+        size_t offsets[radix_buckets];
+        size_t offset = 0;
+        bool trivial = false;
+        for (size_t bucket = 0; bucket < radix_buckets; ++bucket) {
+            offsets[bucket] = offset;
+            offset += counts[d][bucket];
+            trivial = trivial || counts[d][bucket] == elements;
+        }
+        if (trivial) {
+            continue;
+        }
+
+        if (in_temp) {
+            radix_scatter(temp, elements, first, offsets, d * radix_bits);
+        } else {
+            radix_scatter(first, elements, temp, offsets, d * radix_bits);
+        }
+        in_temp = !in_temp;
+    }
+
+    if (in_temp) {
+        std::copy(temp, temp + elements, first);
+    }
+}
+
+/**
+ * element counts from which floki::sort uses radix_sort_range instead of the
+ * AA sort merge passes, by element size. radix sort makes one pass per key
+ * byte while the merge passes grow with log2 of the elements, so narrow keys
+ * cross over early. bench/radix_crossover.cpp measures the crossover of a
+ * machine.
+ * the counts are estimates, not yet measured, so floki::sort only uses them
+ * when FLOKI_SORT_RADIX is defined.
+ */
+template <typename T> struct radix_crossover
+{
+#if defined(FLOKI_SORT_RADIX)
+    static const bool enabled = true;
+#else
+    static const bool enabled = false;
+#endif
+    static const size_t value = sizeof(T) == 1 ? size_t(1) << 12
+                              : sizeof(T) == 2 ? size_t(1) << 14
+                              : sizeof(T) == 4 ? size_t(1) << 20
+                                               : size_t(1) << 22;
+};
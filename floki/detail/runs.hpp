@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * runs shorter than this many elements are not kept, instead adaptive_sort
+ * sorts this many elements from the start of the short run.
+ */
+const size_t adaptive_min_run = 4096;
+
+/**
+ * length of the run at the start of [first, first + elements). the run is
+ * ascending, or non increasing when descending is set.
+ * lanes neighbour pairs are compared a vector at a time with 2 overlapping
+ * loads, so a long run costs one read pass.
+ */
+template <size_t lanes, typename InputIterator>
+inline size_t run_length(InputIterator first, size_t elements, bool descending)
+{
+    using boost::simd::input_begin;
+    using value_type = typename std::iterator_traits<InputIterator>::value_type;
+    using simd_type_t = boost::simd::pack<value_type, lanes>;
+
+    size_t i = 0;
+
+    for (; i + lanes < elements; i += lanes) {
+        simd_type_t current = *input_begin<lanes>(first + i);
+        simd_type_t next = *input_begin<lanes>(first + i + 1);
+
+        auto mask = descending ? boost::simd::hmsb(boost::simd::is_less(current, next))
+                               : boost::simd::hmsb(boost::simd::is_less(next, current));
+        if (mask) {
+            return i + boost::simd::ffs(mask);
+        }
+    }
+
+    for (; i + 1 < elements; ++i) {
+        if (descending ? first[i] < first[i + 1] : first[i + 1] < first[i]) {
+            return i + 1;
+        }
+    }
+
+    return elements;
+}
+
+/**
+ * splits [first, last) into sorted runs and returns their bounds.
+ * ascending and descending runs of at least min_run elements are kept, the
+ * descending ones reversed. where the run is shorter, the next min_run
+ * elements are sorted with sort_range instead.
+ * temp must hold min_run elements.
+ */
+template <class RandomAccessIterator, class TempIterator>
+inline std::vector<size_t> find_runs(RandomAccessIterator first,
+                                     RandomAccessIterator last,
+                                     TempIterator temp, size_t min_run)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t lanes = sort_lanes<value_type>::value;
+    const size_t elements = std::distance(first, last);
+
+    std::vector<size_t> bounds(1, 0);
+
+    for (size_t begin = 0; begin < elements;) {
+        size_t remaining = elements - begin;
+        bool descending = remaining > 1 && first[begin + 1] < first[begin];
+        size_t length = run_length<lanes>(first + begin, remaining, descending);
+
+        if (length >= min_run || length == remaining) {
+            if (descending) {
+                std::reverse(first + begin, first + begin + length);
+            }
+        } else {
+            length = std::min(min_run, remaining);
+            sort_range(first + begin, first + begin + length, temp);
+        }
+
+        begin += length;
+        bounds.push_back(begin);
+    }
+
+    return bounds;
+}
+
+/**
+ * merges adjacent pairs of the runs [bounds[i], bounds[i + 1]) of input into
+ * output and returns the bounds of the merged runs.
+ */
+template <size_t lanes, typename InputIterator, typename OutputIterator>
+inline std::vector<size_t> merge_runs(InputIterator input,
+                                      OutputIterator output,
+                                      const std::vector<size_t> &bounds)
+{
+    std::vector<size_t> merged(1, 0);
+
+    for (size_t r = 0; r + 1 < bounds.size(); r += 2) {
+        size_t run_first = bounds[r];
+        size_t run_middle = bounds[r + 1];
+        size_t run_last = r + 2 < bounds.size() ? bounds[r + 2] : run_middle;
+
+        merge_n<lanes>(input + run_first, run_middle - run_first,
+                       input + run_middle, run_last - run_middle,
+                       output + run_first);
+        merged.push_back(run_last);
+    }
+
+    return merged;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+/**
+ * segments of up to this many values are sorted lanes at a time, one segment
+ * in each lane of a column sorting network.
+ */
+const size_t column_segment_max = 16;
+
+/**
+ * sorts the segments listed in batch, one per lane, with one column sorting
+ * network. segment s is data[offsets[batch[s]], offsets[batch[s] + 1]) and
+ * holds at most column_segment_max values. the columns are padded with the
+ * sentinel up to the power of 2 height of the longest segment.
+ */
+template <size_t lanes, typename RandomAccessIterator, typename OffsetIterator>
+inline void sort_segment_columns(RandomAccessIterator data,
+                                 OffsetIterator offsets, const size_t *batch,
+                                 size_t segments)
+{
+    using boost::simd::input_begin;
+    using boost::simd::output_begin;
+    using value_type
+        = typename std::iterator_traits<RandomAccessIterator>::value_type;
+    using simd_type_t = boost::simd::pack<value_type, lanes>;
+
+    size_t longest = 2;
+    for (size_t s = 0; s < segments; ++s) {
+        longest = std::max<size_t>(longest, offsets[batch[s] + 1]
+                                                - offsets[batch[s]]);
+    }
+    const size_t height = next_power_of_2(longest);
+
+    value_type buffer[column_segment_max * lanes];
+    std::fill(buffer, buffer + height * lanes,
+              ascending::template sentinel<value_type>());
+    for (size_t s = 0; s < segments; ++s) {
+        auto first = data + offsets[batch[s]];
+        size_t elements = offsets[batch[s] + 1] - offsets[batch[s]];
+        for (size_t k = 0; k < elements; ++k) {
+            buffer[k * lanes + s] = first[k];
+        }
+    }
+
+    simd_type_t v[column_segment_max];
+    auto in = input_begin<lanes>(&buffer[0]);
+    for (size_t i = 0; i < height; ++i) {
+        v[i] = *in++;
+    }
+
+    sort_vector_columns(v, height);
+
+    auto out = output_begin<lanes>(&buffer[0]);
+    for (size_t i = 0; i < height; ++i) {
+        *out++ = v[i];
+    }
+
+    for (size_t s = 0; s < segments; ++s) {
+        auto first = data + offsets[batch[s]];
+        size_t elements = offsets[batch[s] + 1] - offsets[batch[s]];
+        for (size_t k = 0; k < elements; ++k) {
+            first[k] = buffer[k * lanes + s];
+        }
+    }
+}
+
+/**
+ * sorts segments [first_segment, last_segment). small segments are collected
+ * into batches of lanes for sort_segment_columns, the others are sorted with
+ * floki::sort on a shared workspace.
+ */
+template <size_t lanes, typename RandomAccessIterator, typename OffsetIterator,
+          typename Workspace>
+inline void sort_segments(RandomAccessIterator data, OffsetIterator offsets,
+                          size_t first_segment, size_t last_segment,
+                          Workspace &workspace)
+{
+    size_t batch[lanes];
+    size_t batched = 0;
+
+    for (size_t s = first_segment; s < last_segment; ++s) {
+        size_t elements = offsets[s + 1] - offsets[s];
+        if (elements < 2) {
+            continue;
+        }
+        if (elements > column_segment_max) {
+            floki::sort(data + offsets[s], data + offsets[s + 1], workspace);
+            continue;
+        }
+
+        batch[batched++] = s;
+        if (batched == lanes) {
+            sort_segment_columns<lanes>(data, offsets, batch, batched);
+            batched = 0;
+        }
+    }
+
+    if (batched) {
+        sort_segment_columns<lanes>(data, offsets, batch, batched);
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * copies the elements of [first, first + elements) that are less than
+ * threshold to out and returns how many were copied.
+ * lanes elements at a time are compared against the threshold in a vector
+ * and only vectors with a candidate lane touch the output.
+ */
+template <size_t lanes, typename InputIterator, typename OutputIterator>
+inline size_t copy_less(InputIterator first, size_t elements,
+                        typename std::iterator_traits
+                        <InputIterator>::value_type threshold,
+                        OutputIterator out)
+{
+    using boost::simd::input_begin;
+    using value_type = typename std::iterator_traits<InputIterator>::value_type;
+    using simd_type_t = boost::simd::pack<value_type, lanes>;
+
+    const simd_type_t limit = boost::simd::splat<simd_type_t>(threshold);
+
+    size_t copied = 0;
+    size_t vector_elements = elements - elements % lanes;
+
+    auto in = input_begin<lanes>(first);
+    for (size_t i = 0; i < vector_elements; i += lanes, ++in) {
+        simd_type_t v = *in;
+        auto mask = boost::simd::hmsb(boost::simd::is_less(v, limit));
+        while (mask) {
+            out[copied++] = v[boost::simd::ffs(mask) - 1];
+            mask &= mask - 1;
+        }
+    }
+
+    for (size_t i = vector_elements; i < elements; ++i) {
+        if (first[i] < threshold) {
+            out[copied++] = first[i];
+        }
+    }
+
+    return copied;
+}
+
+/**
+ * moves the elements less than threshold to the front of [first, last),
+ * followed by the elements equal to it.
+ * the whole range is only scanned once, for the elements not greater than
+ * threshold, which are few when threshold is the k'th smallest for small k.
+ */
+template <class RandomAccessIterator>
+inline void partition_around(RandomAccessIterator first,
+                             RandomAccessIterator last,
+                             typename std::iterator_traits
+                             <RandomAccessIterator>::value_type threshold)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    auto not_greater_last = std::partition(first, last, [&](const value_type &v) {
+        return !(threshold < v);
+    });
+    std::partition(first, not_greater_last, [&](const value_type &v) {
+        return v < threshold;
+    });
+}
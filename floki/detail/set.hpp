@@ -0,0 +1,377 @@
+#pragma once
+
+/**
+ * the set algorithms switch from vector compares to galloping when one range
+ * is more than gallop_ratio times longer than the other.
+ */
+const size_t gallop_ratio = 32;
+
+/**
+ * rotates the lanes of a down by rotation, lane i takes lane
+ * (i + rotation) % lanes.
+ */
+template <int rotation, typename simd_type, int... indices>
+inline simd_type rotate_lanes(simd_type a, lane_list<indices...>)
+{
+    return shuffle<((indices + rotation) % int(sizeof...(indices)))...>(a);
+}
+
+/**
+ * all pairs compare of 2 vectors. bit i of the result is set when lane i of a
+ * is equal to any lane of b. b is compared in every rotation, so a vector of
+ * lanes elements takes lanes compares.
+ */
+template <int rotation> struct match_lanes
+{
+    template <typename simd_type>
+    static size_t apply(simd_type a, simd_type b)
+    {
+        using lanes_t = typename make_lane_list<simd_type::static_size>::type;
+
+        return size_t(boost::simd::hmsb(boost::simd::is_equal(
+                   a, rotate_lanes<rotation>(b, lanes_t())))) |
+               match_lanes<rotation - 1>::apply(a, b);
+    }
+};
+
+template <> struct match_lanes<0>
+{
+    template <typename simd_type>
+    static size_t apply(simd_type a, simd_type b)
+    {
+        return boost::simd::hmsb(boost::simd::is_equal(a, b));
+    }
+};
+
+template <typename simd_type>
+inline size_t match_mask(simd_type a, simd_type b)
+{
+    return match_lanes<int(simd_type::static_size) - 1>::apply(a, b);
+}
+
+/**
+ * writes the lanes of v selected by mask to out, in lane order.
+ */
+template <typename simd_type, typename OutputIterator>
+inline OutputIterator compress_lanes(simd_type v, size_t mask,
+                                     OutputIterator out)
+{
+    while (mask) {
+        *out++ = v[boost::simd::ffs(mask) - 1];
+        mask &= mask - 1;
+    }
+    return out;
+}
+
+template <size_t lanes, typename InputIterator>
+inline boost::simd::pack
+    <typename std::iterator_traits<InputIterator>::value_type, lanes>
+load_lanes(InputIterator first)
+{
+    return *boost::simd::input_begin<lanes>(first);
+}
+
+/**
+ * index of the first element of data[pos, elements) not less than value.
+ * the step doubles until it passes value, and the last step is searched with
+ * floki::find_if.
+ */
+template <typename T>
+inline size_t gallop(const T *data, size_t elements, size_t pos, T value)
+{
+    size_t step = 1;
+    while (pos + step < elements && data[pos + step] < value) {
+        pos += step;
+        step *= 2;
+    }
+
+    auto last = data + std::min(pos + step, elements);
+    return floki::find_if(data + pos, last,
+                          std::bind(greater_equal(), std::placeholders::_1,
+                                    value)) - data;
+}
+
+inline bool gallop_ranges(size_t a_elements, size_t b_elements)
+{
+    return std::min(a_elements, b_elements) * gallop_ratio
+           < std::max(a_elements, b_elements);
+}
+
+/**
+ * intersection of the sorted sets a and b.
+ * a vector of each set is compared all pairs. the lanes of a found in b are
+ * written out, and the vector with the smaller last element is replaced.
+ */
+template <size_t lanes, typename InputIterator1, typename InputIterator2,
+          typename OutputIterator>
+inline OutputIterator intersect_n(InputIterator1 a, size_t a_elements,
+                                  InputIterator2 b, size_t b_elements,
+                                  OutputIterator out)
+{
+    size_t i = 0;
+    size_t j = 0;
+
+    if (a_elements >= lanes && b_elements >= lanes) {
+        auto va = load_lanes<lanes>(a);
+        auto vb = load_lanes<lanes>(b);
+
+        for (;;) {
+            out = compress_lanes(va, match_mask(va, vb), out);
+
+            const auto a_last = a[i + lanes - 1];
+            const auto b_last = b[j + lanes - 1];
+
+            if (!(b_last < a_last)) {
+                i += lanes;
+                if (i + lanes > a_elements) {
+                    break;
+                }
+                va = load_lanes<lanes>(a + i);
+            }
+            if (!(a_last < b_last)) {
+                j += lanes;
+                if (j + lanes > b_elements) {
+                    break;
+                }
+                vb = load_lanes<lanes>(b + j);
+            }
+        }
+    }
+
+    return std::set_intersection(a + i, a + a_elements, b + j, b + b_elements,
+                                 out);
+}
+
+/**
+ * elements of the sorted set a that are not in the sorted set b.
+ * the lanes of a vector of a found in b are collected until the vector is
+ * replaced, then the other lanes are written out.
+ */
+template <size_t lanes, typename InputIterator1, typename InputIterator2,
+          typename OutputIterator>
+inline OutputIterator difference_n(InputIterator1 a, size_t a_elements,
+                                   InputIterator2 b, size_t b_elements,
+                                   OutputIterator out)
+{
+    using value_type = typename std::iterator_traits<InputIterator1>::value_type;
+
+    const size_t all_lanes = (size_t(1) << lanes) - 1;
+
+    size_t i = 0;
+    size_t j = 0;
+
+    if (a_elements >= lanes && b_elements >= lanes) {
+        auto va = load_lanes<lanes>(a);
+        auto vb = load_lanes<lanes>(b);
+        size_t found = 0;
+
+        for (;;) {
+            found |= match_mask(va, vb);
+
+            const auto a_last = a[i + lanes - 1];
+            const auto b_last = b[j + lanes - 1];
+
+            if (!(b_last < a_last)) {
+                out = compress_lanes(va, ~found & all_lanes, out);
+                found = 0;
+                i += lanes;
+                if (i + lanes > a_elements) {
+                    break;
+                }
+                va = load_lanes<lanes>(a + i);
+            }
+            if (!(a_last < b_last)) {
+                j += lanes;
+                if (j + lanes > b_elements) {
+                    break;
+                }
+                vb = load_lanes<lanes>(b + j);
+            }
+        }
+
+        // the vector of a still loaded has only been compared to the part of
+        // b already passed.
+        if (i + lanes <= a_elements) {
+            value_type rest[lanes];
+            auto rest_end = compress_lanes(va, ~found & all_lanes, &rest[0]);
+            out = std::set_difference(&rest[0], rest_end, b + j,
+                                      b + b_elements, out);
+            i += lanes;
+        }
+    }
+
+    return std::set_difference(a + i, a + a_elements, b + j, b + b_elements,
+                               out);
+}
+
+/**
+ * stores a merged 2 vector group, dropping every value equal to the value
+ * before it. last is the last value written and is updated. no more than
+ * elements values of the group are looked at.
+ */
+template <typename simd_type, typename OutputIterator>
+inline void store_unique(OutputIterator &dest, size_t &elements, simd_type lo,
+                         simd_type hi,
+                         typename simd_type::value_type &last, bool &written)
+{
+    using boost::simd::input_begin;
+    using boost::simd::output_begin;
+    using value_type = typename simd_type::value_type;
+    const size_t lanes = simd_type::static_size;
+
+    value_type buffer[2 * lanes + 1];
+    buffer[0] = last;
+
+    auto out = output_begin<lanes>(&buffer[1]);
+    *out++ = lo;
+    *out = hi;
+
+    auto previous = input_begin<lanes>(&buffer[0]);
+    simd_type lo_previous = *previous++;
+    simd_type hi_previous = *previous;
+
+    size_t mask = size_t(boost::simd::hmsb(boost::simd::is_not_equal(lo, lo_previous)))
+                  | size_t(boost::simd::hmsb(boost::simd::is_not_equal(hi, hi_previous)))
+                        << lanes;
+    if (!written) {
+        mask |= 1;
+    }
+
+    size_t count = std::min(elements, 2 * lanes);
+    if (count < 2 * lanes) {
+        mask &= (size_t(1) << count) - 1;
+    }
+
+    while (mask) {
+        *dest++ = buffer[boost::simd::ffs(mask)];
+        mask &= mask - 1;
+    }
+
+    last = buffer[count];
+    written = true;
+    elements -= count;
+}
+
+/**
+ * union of the sorted sets a and b with the merge_n kernel. a value in both
+ * sets comes out of the merge twice in a row, the copy is dropped when the
+ * merged group is stored. when both runs have elements, values repeated
+ * within a run are dropped as well.
+ */
+template <size_t lanes, typename InputIterator1, typename InputIterator2,
+          typename OutputIterator>
+inline OutputIterator union_n(InputIterator1 a, size_t a_elements,
+                              InputIterator2 b, size_t b_elements,
+                              OutputIterator dest)
+{
+    using value_type = typename std::iterator_traits<InputIterator1>::value_type;
+    using simd_type_t = boost::simd::pack<value_type, lanes>;
+
+    if (!a_elements) {
+        return std::copy(b, b + b_elements, dest);
+    }
+    if (!b_elements) {
+        return std::copy(a, a + a_elements, dest);
+    }
+
+    size_t remaining = a_elements + b_elements;
+    value_type last = value_type();
+    bool written = false;
+    simd_type_t a1, a2, b1, b2;
+
+    load_group(a, a_elements, a1, a2);
+    load_group(b, b_elements, b1, b2);
+
+    for (;;) {
+        tie(a1, a2, b1, b2) = bitonic_merge(a1, a2, b1, b2);
+        store_unique(dest, remaining, a1, a2, last, written);
+        a1 = b1;
+        a2 = b2;
+
+        if (a_elements && (!b_elements || *a < *b)) {
+            load_group(a, a_elements, b1, b2);
+        } else if (b_elements) {
+            load_group(b, b_elements, b1, b2);
+        } else {
+            break;
+        }
+    }
+
+    if (remaining) {
+        store_unique(dest, remaining, a1, a2, last, written);
+    }
+    return dest;
+}
+
+/**
+ * intersection of a sorted set with a much longer one. every element of
+ * small is galloped to in large.
+ */
+template <typename T, typename OutputIterator>
+inline OutputIterator gallop_intersection(const T *small, size_t small_elements,
+                                          const T *large, size_t large_elements,
+                                          OutputIterator out)
+{
+    size_t j = 0;
+    for (size_t i = 0; i < small_elements && j < large_elements; ++i) {
+        j = gallop(large, large_elements, j, small[i]);
+        if (j < large_elements && !(small[i] < large[j])) {
+            *out++ = small[i];
+            ++j;
+        }
+    }
+    return out;
+}
+
+/**
+ * union of a sorted set with a much longer one. the elements of large
+ * between 2 elements of small are copied as a block.
+ */
+template <typename T, typename OutputIterator>
+inline OutputIterator gallop_union(const T *small, size_t small_elements,
+                                   const T *large, size_t large_elements,
+                                   OutputIterator out)
+{
+    size_t j = 0;
+    for (size_t i = 0; i < small_elements; ++i) {
+        size_t next = gallop(large, large_elements, j, small[i]);
+        out = std::copy(large + j, large + next, out);
+        j = next;
+        if (j < large_elements && !(small[i] < large[j])) {
+            ++j;
+        }
+        *out++ = small[i];
+    }
+    return std::copy(large + j, large + large_elements, out);
+}
+
+/**
+ * a \ b where one of the sets is much longer than the other.
+ */
+template <typename T, typename OutputIterator>
+inline OutputIterator gallop_difference(const T *a, size_t a_elements,
+                                        const T *b, size_t b_elements,
+                                        OutputIterator out)
+{
+    if (a_elements < b_elements) {
+        size_t j = 0;
+        for (size_t i = 0; i < a_elements; ++i) {
+            j = gallop(b, b_elements, j, a[i]);
+            if (j == b_elements || a[i] < b[j]) {
+                *out++ = a[i];
+            }
+        }
+        return out;
+    }
+
+    size_t i = 0;
+    for (size_t j = 0; j < b_elements && i < a_elements; ++j) {
+        size_t next = gallop(a, a_elements, i, b[j]);
+        out = std::copy(a + i, a + next, out);
+        i = next;
+        if (i < a_elements && !(b[j] < a[i])) {
+            ++i;
+        }
+    }
+    return std::copy(a + i, a + a_elements, out);
+}
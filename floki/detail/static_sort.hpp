@@ -0,0 +1,77 @@
+#pragma once
+
+/**
+ * smallest power of 2 not less than n.
+ */
+constexpr size_t next_power_of_2(size_t n, size_t power = 1)
+{
+    return power >= n ? power : next_power_of_2(n, 2 * power);
+}
+
+/**
+ * lanes of the vectors static_sort sorts N values of value_type with. the
+ * widest vectors whose sort block is no bigger than N, so few lanes are
+ * padding. no less than 2 lanes.
+ */
+template <typename value_type, size_t N,
+          size_t lanes = sort_lanes<value_type>::value>
+struct static_lanes
+    : std::conditional<
+          (lanes > 2 && lanes * block_vectors<lanes>::value > N),
+          static_lanes<value_type, N, lanes / 2>,
+          std::integral_constant<size_t, lanes>>::type
+{
+};
+
+/**
+ * vectors static_sort loads N values into. a power of 2 and at least one
+ * sort block, so bitonic_sort_block sorts them in one network.
+ */
+template <size_t N, size_t lanes>
+struct static_vectors
+    : std::integral_constant<
+          size_t, (next_power_of_2((N + lanes - 1) / lanes)
+                       < block_vectors<lanes>::value
+                   ? block_vectors<lanes>::value
+                   : next_power_of_2((N + lanes - 1) / lanes))>
+{
+};
+
+/**
+ * sorts the N values at first in Order with a single sorting network. the
+ * values are loaded into a fixed array of vectors, padded with the order's
+ * sentinel, so every loop has a compile time trip count.
+ */
+template <size_t N, typename Order, typename RandomAccessIterator>
+inline void static_sort_n(RandomAccessIterator first)
+{
+    using boost::simd::input_begin;
+    using boost::simd::output_begin;
+    using value_type
+        = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+    const size_t lanes = static_lanes<value_type, N>::value;
+    const size_t vectors = static_vectors<N, lanes>::value;
+
+    using simd_type_t = typename ordered_type
+        <boost::simd::pack<value_type, lanes>, Order>::type;
+
+    value_type buffer[vectors * lanes];
+    std::copy(first, first + N, buffer);
+    std::fill(buffer + N, buffer + vectors * lanes,
+              Order::template sentinel<value_type>());
+
+    simd_type_t v[vectors];
+    auto in = input_begin<lanes>(&buffer[0]);
+    for (size_t i = 0; i < vectors; ++i) {
+        v[i] = simd_type_t(*in++);
+    }
+
+    bitonic_sort_block(v);
+
+    auto out = output_begin<lanes>(&buffer[0]);
+    for (size_t i = 0; i < vectors; ++i) {
+        *out++ = unordered(v[i]);
+    }
+    std::copy(buffer, buffer + N, first);
+}
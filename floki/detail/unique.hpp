@@ -0,0 +1,59 @@
+#pragma once
+
+/**
+ * the vector of lanes prev[lanes - 1], cur[0], ..., cur[lanes - 2], so lane i
+ * holds the neighbor before lane i of cur.
+ */
+template <typename simd_type, int... indices>
+inline simd_type shift_in(simd_type prev, simd_type cur, lane_list<indices...>)
+{
+    return shuffle<(indices + int(sizeof...(indices)) - 1)...>(prev, cur);
+}
+
+/**
+ * writes the first element of every run of equal elements in
+ * [first, first + elements) to out and returns the end of the output.
+ * each vector is compared with itself shifted by one lane, with the last lane
+ * of the vector before shifted in, and the lanes that differ from their
+ * neighbor are written out. out may be first, the output never passes the
+ * vector being read.
+ */
+template <size_t lanes, typename InputIterator, typename OutputIterator>
+inline OutputIterator unique_n(InputIterator first, size_t elements,
+                               OutputIterator out)
+{
+    using value_type = typename std::iterator_traits<InputIterator>::value_type;
+    using simd_type_t = boost::simd::pack<value_type, lanes>;
+    using lanes_t = typename make_lane_list<lanes>::type;
+
+    if (!elements) {
+        return out;
+    }
+
+    size_t vector_elements = elements - elements % lanes;
+
+    simd_type_t prev;
+    for (size_t i = 0; i < vector_elements; i += lanes) {
+        simd_type_t cur = load_lanes<lanes>(first + i);
+        if (!i) {
+            prev = cur;
+        }
+        // the first element always stays
+        size_t mask = boost::simd::hmsb(boost::simd::is_not_equal(
+                          cur, shift_in(prev, cur, lanes_t()))) | size_t(!i);
+        out = compress_lanes(cur, mask, out);
+        prev = cur;
+    }
+
+    // first[i - 1] may already be overwritten when out is first
+    value_type last = vector_elements ? prev[lanes - 1] : value_type();
+    for (size_t i = vector_elements; i < elements; ++i) {
+        value_type v = first[i];
+        if (!i || last != v) {
+            *out++ = v;
+        }
+        last = v;
+    }
+
+    return out;
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace floki
+{
+
+/**
+ * floki kernels compiled for several instruction set levels in one build,
+ * with the level picked once from cpuid, on the first call.
+ *
+ * each level is built as its own shared library, floki_sse4, floki_avx2 and
+ * floki_avx512, with hidden symbols, so the inline functions of one level
+ * are never linked into another. floki_dispatch links them all and picks
+ * the highest level the cpu supports. the FLOKI_ISA environment variable,
+ * set to sse4, avx2 or avx512, selects a lower level.
+ *
+ * floki::dispatch::sort(values.data(), values.data() + values.size());
+ */
+namespace dispatch
+{
+
+enum class isa { sse4, avx2, avx512 };
+
+/**
+ * the kernels of one instruction set level.
+ */
+struct kernels
+{
+    isa level;
+
+    void (*sort_int32)(int32_t *first, int32_t *last);
+    void (*sort_uint32)(uint32_t *first, uint32_t *last);
+    void (*sort_int64)(int64_t *first, int64_t *last);
+    void (*sort_uint64)(uint64_t *first, uint64_t *last);
+    void (*sort_float)(float *first, float *last);
+    void (*sort_double)(double *first, double *last);
+
+    const int32_t *(*find_greater_equal_int32)(const int32_t *first,
+                                               const int32_t *last,
+                                               int32_t value);
+    const uint32_t *(*find_greater_equal_uint32)(const uint32_t *first,
+                                                 const uint32_t *last,
+                                                 uint32_t value);
+    const float *(*find_greater_equal_float)(const float *first,
+                                             const float *last, float value);
+
+    uint32_t (*bfs_search_int32)(const int32_t *begin, const int32_t *end,
+                                 int32_t key, uint32_t k);
+    uint32_t (*bfs_search_float)(const float *begin, const float *end,
+                                 float key, uint32_t k);
+};
+
+/**
+ * true when the cpu runs level.
+ */
+bool supported(isa level);
+
+/**
+ * the kernels of level. throws std::invalid_argument when the cpu does not
+ * support level.
+ */
+const kernels &kernels_for(isa level);
+
+/**
+ * the level the kernels run at, picked on the first call. throws
+ * std::runtime_error when the cpu does not support sse4, the lowest level.
+ */
+isa selected();
+
+const char *name(isa level);
+
+/**
+ * the kernels of the selected level. throws like selected().
+ */
+const kernels &active();
+
+/**
+ * floki::sort of [first, last).
+ */
+inline void sort(int32_t *first, int32_t *last)
+{
+    active().sort_int32(first, last);
+}
+
+inline void sort(uint32_t *first, uint32_t *last)
+{
+    active().sort_uint32(first, last);
+}
+
+inline void sort(int64_t *first, int64_t *last)
+{
+    active().sort_int64(first, last);
+}
+
+inline void sort(uint64_t *first, uint64_t *last)
+{
+    active().sort_uint64(first, last);
+}
+
+inline void sort(float *first, float *last)
+{
+    active().sort_float(first, last);
+}
+
+inline void sort(double *first, double *last)
+{
+    active().sort_double(first, last);
+}
+
+/**
+ * floki::find_if with floki::greater_equal, the first element of
+ * [first, last) not less than value.
+ */
+inline const int32_t *find_greater_equal(const int32_t *first,
+                                         const int32_t *last, int32_t value)
+{
+    return active().find_greater_equal_int32(first, last, value);
+}
+
+inline const uint32_t *find_greater_equal(const uint32_t *first,
+                                          const uint32_t *last, uint32_t value)
+{
+    return active().find_greater_equal_uint32(first, last, value);
+}
+
+inline const float *find_greater_equal(const float *first, const float *last,
+                                       float value)
+{
+    return active().find_greater_equal_float(first, last, value);
+}
+
+/**
+ * true for the k the dispatched bfs::search is built for, one node of 2, 4,
+ * 8 or 16 keys.
+ */
+inline bool bfs_arity(uint32_t k)
+{
+    return k == 3 || k == 5 || k == 9 || k == 17;
+}
+
+/**
+ * bfs::search<T, k> of a tree linearized with floki::bfs::linearize. k is
+ * 3, 5, 9 or 17.
+ */
+inline uint32_t bfs_search(const int32_t *begin, const int32_t *end,
+                           int32_t key, uint32_t k)
+{
+    if (!bfs_arity(k)) {
+        throw std::invalid_argument("floki::dispatch::bfs_search: k");
+    }
+    return active().bfs_search_int32(begin, end, key, k);
+}
+
+inline uint32_t bfs_search(const float *begin, const float *end, float key,
+                           uint32_t k)
+{
+    if (!bfs_arity(k)) {
+        throw std::invalid_argument("floki::dispatch::bfs_search: k");
+    }
+    return active().bfs_search_float(begin, end, key, k);
+}
+}
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <floki/multiway_sort.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/external.hpp>
+}
+
+/**
+ * sorts a binary file of T keys that does not fit in memory.
+ *
+ * the input is read in runs of a third of memory_budget bytes, each run is
+ * sorted with floki::sort and written to output_path + ".runs", reading the
+ * next run while the current one is sorted. the runs file is then mapped and
+ * all runs are merged in one pass with the multiway merge of multiway_sort,
+ * writing each merged segment while the next is merged. input that fits in
+ * one run is sorted without the runs file.
+ * I/O errors throw std::system_error.
+ */
+template <typename T>
+inline void external_sort(const std::string &input_path,
+                          const std::string &output_path, size_t memory_budget)
+{
+    detail::posix_file input(input_path, O_RDONLY);
+
+    if (input.size() % sizeof(T)) {
+        throw std::runtime_error(input_path + " is not a whole number of keys");
+    }
+
+    // current and next run plus the sort scratch
+    const size_t run_elements
+        = std::max<size_t>(memory_budget / (3 * sizeof(T)), 1024);
+    const size_t elements = input.size() / sizeof(T);
+
+    detail::posix_file output(output_path, O_WRONLY | O_CREAT | O_TRUNC);
+
+    if (elements <= run_elements) {
+        detail::write_sorted_runs<T>(input, output, run_elements);
+        return;
+    }
+
+    const std::string runs_path = output_path + ".runs";
+
+    try {
+        std::vector<size_t> bounds;
+        {
+            detail::posix_file runs(runs_path, O_WRONLY | O_CREAT | O_TRUNC);
+            bounds = detail::write_sorted_runs<T>(input, runs, run_elements);
+        }
+
+        detail::posix_file runs(runs_path, O_RDONLY);
+        detail::mapped_file mapped(runs);
+        ::madvise(const_cast<void *>(mapped.data()), runs.size(),
+                  MADV_SEQUENTIAL);
+
+        // 2 merge buffers and 2 output segments
+        const size_t segment = std::max<size_t>(
+            std::min<size_t>(memory_budget / (4 * sizeof(T)),
+                             detail::multiway_cache_bytes / sizeof(T)),
+            1024);
+
+        detail::merge_runs_to_file(static_cast<const T *>(mapped.data()),
+                                   bounds, output, segment);
+    } catch (...) {
+        std::remove(runs_path.c_str());
+        throw;
+    }
+
+    std::remove(runs_path.c_str());
+}
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <boost/simd/memory/allocator.hpp>
+
+#include <floki/algorithms.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/parallel_for.hpp>
+#include <floki/detail/kary.hpp>
+}
+
+/**
+ * immutable breadth first k-ary search index over a sorted range of any
+ * length, sized at run time.
+ *
+ * the keys are stored level by level in aligned heap memory, k - 1 keys a
+ * node, and every node is searched with floki::find_if. the tree is the
+ * smallest complete k-ary tree with room for the keys. the positions past
+ * the last key are padded with copies of it, so the tree stays sorted for any
+ * T. the levels above the last are complete and the last level ends at its
+ * last node holding a key, so the index
+ * stores at most about twice the keys.
+ *
+ * pick k so k - 1 keys fill one or a few vectors, e.g. k = 17 for int32_t
+ * with 16 byte vectors.
+ *
+ * floki::kary_index<int32_t, 17> index(begin(sorted), end(sorted));
+ * size_t position = index.search(key); // std::lower_bound position
+ */
+template <typename T, uint32_t k> class kary_index
+{
+    static_assert(k >= 2, "a k-ary tree needs k >= 2");
+
+public:
+    using value_t = T;
+
+    kary_index() : m_size(0), m_levels(0) {}
+
+    /**
+     * builds the index of the sorted range [first, last). large indexes are
+     * built on up to threads threads.
+     */
+    template <typename RandomAccessIterator>
+    kary_index(RandomAccessIterator first, RandomAccessIterator last,
+               unsigned threads = 1)
+        : m_size(std::distance(first, last)),
+          m_levels(detail::kary_levels(k, m_size)),
+          m_values(detail::kary_stored_keys(k, m_size))
+    {
+        if (m_size) {
+            detail::kary_linearize(first, m_size, k, value_t(first[m_size - 1]),
+                                   &m_values[0], threads);
+        }
+    }
+
+    /**
+     * number of keys indexed.
+     */
+    size_t size() const { return m_size; }
+
+    bool empty() const { return !m_size; }
+
+    /**
+     * levels of the tree, the nodes each search reads.
+     */
+    size_t levels() const { return m_levels; }
+
+    /**
+     * the tree, level by level, stored_size() values.
+     */
+    const value_t *data() const { return m_values.data(); }
+
+    size_t stored_size() const { return m_values.size(); }
+
+    /**
+     * number of indexed keys less than key, the position std::lower_bound
+     * returns in the sorted range the index was built from.
+     */
+    size_t search(value_t key) const
+    {
+        if (!m_size) {
+            return 0;
+        }
+        return std::min(detail::kary_search<k>(data(), stored_size(),
+                                               m_levels, key),
+                        m_size);
+    }
+
+    /**
+     * search of the n keys at keys, the positions are written to out.
+     * see bfs::search_batch.
+     */
+    template <typename OutputIterator>
+    OutputIterator search_batch(const value_t *keys, size_t n,
+                                OutputIterator out) const
+    {
+        if (!m_size) {
+            return std::fill_n(out, n, size_t(0));
+        }
+        return detail::kary_search_batch<k>(data(), stored_size(), m_levels,
+                                            m_size, keys, n, out);
+    }
+
+private:
+    size_t m_size;
+    size_t m_levels;
+    std::vector<value_t, boost::simd::allocator<value_t>> m_values;
+};
+
+namespace bfs
+{
+
+/**
+ * looks up the n keys at keys in tree and writes their std::lower_bound
+ * positions to out. the lookups go through the tree in groups, a level at a
+ * time, each prefetching its next node while the rest of the group searches,
+ * so the cache misses of a large tree overlap.
+ */
+template <typename T, uint32_t k, typename OutputIterator>
+inline OutputIterator search_batch(const kary_index<T, k> &tree,
+                                   const T *keys, size_t n,
+                                   OutputIterator out)
+{
+    return tree.search_batch(keys, n, out);
+}
+}
+};
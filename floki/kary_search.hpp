@@ -4,6 +4,10 @@
 #include <cassert>
 #include <tuple>
 #include <iostream>
+#include <functional>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 #include "algorithms.hpp"
 
@@ -15,13 +19,18 @@
 #include <boost/bind.hpp>
 namespace floki {
 
+namespace detail {
+#include "detail/parallel_for.hpp"
+#include "detail/kary.hpp"
+}
+
 namespace {
 
 /*
  * Linearization functions
  */
 inline uint32_t S(uint32_t R, uint32_t k, uint32_t N) {
-  return N / (std::pow(k, R + 1));
+  return N / detail::kary_power(k, R + 1);
 }
 }
 
@@ -70,14 +79,19 @@ make_iterator(InputIterator values, uint32_t k, uint32_t N, uint32_t position) {
 
 /**
  * @brief linearize a sorted array for bfs
- * @details both input and output arrays should have N-1 elements
+ * @details both input and output arrays should have N-1 elements, N a power
+ * of k. the tree is written level by level in O(N) integer steps, on up to
+ * threads threads for large N.
  *
  */
 template <typename key_type>
 void linearize(const key_type *sorted_array, uint32_t k, uint32_t N,
-               key_type *linearized_array) {
-  std::copy(sorted_array, sorted_array + (N - 1),
-            make_iterator(linearized_array, k, N, 0));
+               key_type *linearized_array, unsigned threads = 1) {
+  assert(detail::kary_stored_keys(k, N - 1) == N - 1);
+  if (N > 1) {
+    detail::kary_linearize(sorted_array, N - 1, k, sorted_array[N - 2],
+                           linearized_array, threads);
+  }
 }
 
 /**
@@ -113,12 +127,32 @@ inline uint32_t search(const T *begin, const T *end,
   return sorted_position;
 }
 
-template <uint32_t k, typename InputIt, typename OutputIt>
-void linearize(InputIt first, InputIt last, OutputIt d_first) {
+/**
+ * bfs::search of the n keys at keys, the sorted positions are written to out.
+ * the lookups go through the tree in groups, a level at a time, and prefetch
+ * their next node while the rest of the group searches, so trees larger
+ * than the cache do not wait on one miss per level per key.
+ */
+template <typename T, uint32_t k, typename OutputIt>
+inline OutputIt search_batch(const T *begin, const T *end, const T *keys,
+                             size_t n, OutputIt out) {
+  const size_t elements = std::distance(begin, end);
+  return detail::kary_search_batch<k>(begin, elements,
+                                      detail::kary_levels(k, elements),
+                                      elements, keys, n, out);
+}
 
-  auto N = std::distance(first, last) + 1;
-  assert(N >= k);
-  std::copy(first, last, make_iterator(&d_first[0], k, N, 0));
+template <uint32_t k, typename InputIt, typename OutputIt>
+void linearize(InputIt first, InputIt last, OutputIt d_first,
+               unsigned threads = 1) {
+
+  size_t elements = std::distance(first, last);
+  assert(!elements || elements + 1 >= k);
+  assert(detail::kary_stored_keys(k, elements) == elements);
+  if (elements) {
+    detail::kary_linearize(first, elements, k, first[elements - 1],
+                           &d_first[0], threads);
+  }
 }
 
 /**
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <floki/parallel_sort.hpp>
+
+namespace floki
+{
+
+/**
+ * merges the sorted ranges [first1, last1) and [first2, last2) into out and
+ * returns the end of the output, like std::merge.
+ *
+ * the ranges can have any length and alignment. the merge runs on the bitonic
+ * merge kernels of floki::sort, with the last vectors of each range padded
+ * with sentinels. large merges are split along merge path diagonals across
+ * threads. the ranges are sorted in Order, see floki/order.hpp.
+ */
+template <class Order = ascending, class InputIterator1, class InputIterator2,
+          class OutputIterator>
+inline OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
+                            InputIterator2 first2, InputIterator2 last2,
+                            OutputIterator out,
+                            unsigned threads = std::thread::hardware_concurrency())
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    const size_t a_elements = std::distance(first1, last1);
+    const size_t b_elements = std::distance(first2, last2);
+
+    threads = detail::parallel_threads(a_elements + b_elements, threads);
+
+    if (threads == 1) {
+        detail::merge_n<lanes, Order>(first1, a_elements, first2, b_elements,
+                                      out);
+    } else {
+        detail::parallel_merge<lanes, Order>(first1, a_elements, first2,
+                                             b_elements, out, threads);
+    }
+
+    return out + (a_elements + b_elements);
+}
+
+/**
+ * merges the sorted ranges [first, middle) and [middle, last) in place, like
+ * std::inplace_merge.
+ *
+ * elements of the first range not greater than *middle and elements of the
+ * second range not less than *(middle - 1) are already in place and are left
+ * alone. on one thread only the rest of the first range is moved to scratch
+ * memory, and the merge writes behind its reads of the second range. on more
+ * threads the whole unsettled part is moved to scratch and merged back along
+ * merge path diagonals.
+ */
+template <class Order = ascending, class RandomAccessIterator>
+inline void inplace_merge(RandomAccessIterator first,
+                          RandomAccessIterator middle,
+                          RandomAccessIterator last,
+                          unsigned threads = std::thread::hardware_concurrency())
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    if (first == middle || middle == last) {
+        return;
+    }
+
+    first = std::upper_bound(first, middle, *middle,
+                             Order::template less<value_type>);
+    last = std::lower_bound(middle, last, *(middle - 1),
+                            Order::template less<value_type>);
+
+    const size_t a_elements = std::distance(first, middle);
+    const size_t b_elements = std::distance(middle, last);
+
+    if (!a_elements || !b_elements) {
+        return;
+    }
+
+    threads = detail::parallel_threads(a_elements + b_elements, threads);
+
+    sort_workspace<value_type> workspace;
+
+    if (threads == 1) {
+        auto temp = workspace.scratch(a_elements);
+        std::copy(first, middle, temp);
+        detail::merge_n<lanes, Order>(temp, a_elements, middle, b_elements,
+                                      first);
+        return;
+    }
+
+    const size_t elements = a_elements + b_elements;
+    auto temp = workspace.scratch(elements);
+
+    detail::parallel_for(threads, [&](unsigned t) {
+        size_t begin = detail::split_point(elements, threads, t);
+        size_t end = detail::split_point(elements, threads, t + 1);
+        std::copy(first + begin, first + end, temp + begin);
+    });
+
+    detail::parallel_merge<lanes, Order>(temp, a_elements, temp + a_elements,
+                                         b_elements, first, threads);
+}
+};
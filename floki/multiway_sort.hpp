@@ -0,0 +1,37 @@
+#pragma once
+
+#include <floki/aa_sort.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/multiway.hpp>
+}
+
+/**
+ * cache aware sort for inputs much larger than the last level cache.
+ *
+ * floki::sort streams the whole array through memory on every merge pass,
+ * log2(n / 16) times. multiway_sort sorts cache sized chunks in cache, then
+ * merges up to 64 runs per pass, so large inputs go through memory only 2 to
+ * 3 times. each multiway merge builds its output in cache sized segments,
+ * merging the pieces of all runs with a tree of bitonic merge kernels.
+ */
+template <class RandomAccessIterator>
+inline void multiway_sort(RandomAccessIterator first, RandomAccessIterator last)
+{
+    typedef typename RandomAccessIterator::value_type value_type;
+
+    const size_t chunk = detail::multiway_cache_bytes / (2 * sizeof(value_type));
+    const size_t elements = std::distance(first, last);
+
+    if (elements <= 2 * chunk) {
+        floki::sort(first, last);
+        return;
+    }
+
+    detail::multiway_sort(first, last, chunk, detail::multiway_ways, chunk);
+}
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <limits>
+#include <type_traits>
+
+#include <boost/simd/include/pack.hpp>
+#include <boost/simd/include/functions/simd/min.hpp>
+#include <boost/simd/include/functions/simd/max.hpp>
+#include <boost/simd/include/functions/simd/abs.hpp>
+#include <boost/simd/include/functions/simd/if_else.hpp>
+#include <boost/simd/include/functions/simd/is_less.hpp>
+#include <boost/simd/include/functions/simd/bitwise_cast.hpp>
+#include <boost/simd/include/functions/splat.hpp>
+
+#include <boost/tuple/tuple.hpp>
+
+namespace floki
+{
+
+/**
+ * sort orders for floki::sort. an order is a compile time policy with
+ *   less(a, b)       scalar compare, used to pick the next run in a merge
+ *   minmax(a, b)     vector compare exchange of the sorting networks
+ *   sentinel<T>()    a value that sorts last, used to pad partial vectors
+ */
+
+/**
+ * ascending order of <. the default order, and the only one floki::sort
+ * hands to radix_sort.
+ */
+struct ascending
+{
+    template <typename T> static bool less(const T &a, const T &b)
+    {
+        return a < b;
+    }
+
+    template <typename simd_type>
+    static boost::tuples::tuple<simd_type, simd_type> minmax(simd_type a,
+                                                             simd_type b)
+    {
+        return boost::tuples::make_tuple(boost::simd::min(a, b),
+                                         boost::simd::max(a, b));
+    }
+
+    template <typename T> static T sentinel()
+    {
+        return std::numeric_limits<T>::has_infinity
+                   ? std::numeric_limits<T>::infinity()
+                   : std::numeric_limits<T>::max();
+    }
+};
+
+/**
+ * descending order. the networks take max where they take min, so it costs
+ * the same as ascending.
+ */
+struct descending
+{
+    template <typename T> static bool less(const T &a, const T &b)
+    {
+        return b < a;
+    }
+
+    template <typename simd_type>
+    static boost::tuples::tuple<simd_type, simd_type> minmax(simd_type a,
+                                                             simd_type b)
+    {
+        return boost::tuples::make_tuple(boost::simd::max(a, b),
+                                         boost::simd::min(a, b));
+    }
+
+    template <typename T> static T sentinel()
+    {
+        return std::numeric_limits<T>::has_infinity
+                   ? -std::numeric_limits<T>::infinity()
+                   : std::numeric_limits<T>::lowest();
+    }
+};
+
+/**
+ * ascending order of the keys mapped to a signed type of the same size.
+ * compare exchange selects with one vector compare of the mapped keys.
+ */
+template <typename Key> struct key_order
+{
+    template <typename T> static bool less(const T &a, const T &b)
+    {
+        return Key::key(a) < Key::key(b);
+    }
+
+    template <typename simd_type>
+    static boost::tuples::tuple<simd_type, simd_type> minmax(simd_type a,
+                                                             simd_type b)
+    {
+        using boost::simd::if_else;
+
+        auto swap = boost::simd::is_less(Key::key(b), Key::key(a));
+        return boost::tuples::make_tuple(if_else(swap, b, a), if_else(swap, a, b));
+    }
+
+    template <typename T> static T sentinel() { return Key::template last<T>(); }
+};
+
+namespace detail
+{
+/**
+ * signed integer of the same size as T.
+ */
+template <typename T>
+struct signed_of : std::make_signed<typename std::conditional
+                                    <std::is_integral<T>::value, T, int>::type>
+{
+};
+
+/**
+ * flips the sign bit, which maps unsigned order onto signed order.
+ */
+template <typename T> inline T flip_sign(T x)
+{
+    typedef typename std::make_unsigned<T>::type unsigned_type;
+    return T(unsigned_type(x) ^ (unsigned_type(1) << (8 * sizeof(T) - 1)));
+}
+
+template <typename T, size_t N>
+inline boost::simd::pack<T, N> flip_sign(boost::simd::pack<T, N> x)
+{
+    typedef typename std::make_unsigned<T>::type unsigned_type;
+    return x ^ boost::simd::splat<boost::simd::pack<T, N>>(
+        T(unsigned_type(1) << (8 * sizeof(T) - 1)));
+}
+
+/**
+ * magnitude of a signed integer as the unsigned bits of T, computed
+ * without overflow for the smallest value.
+ */
+template <typename T> inline T magnitude(T x)
+{
+    typedef typename std::make_unsigned<T>::type unsigned_type;
+    unsigned_type u = unsigned_type(x);
+    unsigned_type s = x < 0 ? unsigned_type(-1) : unsigned_type(0);
+    return T(unsigned_type((u ^ s) - s));
+}
+
+template <typename T, size_t N>
+inline boost::simd::pack<T, N> magnitude(boost::simd::pack<T, N> x)
+{
+    typedef typename std::make_unsigned<T>::type unsigned_type;
+    typedef boost::simd::pack<unsigned_type, N> unsigned_pack;
+
+    unsigned_pack u = boost::simd::bitwise_cast<unsigned_pack>(x);
+    unsigned_pack s = -(u >> int(8 * sizeof(T) - 1));
+    return boost::simd::bitwise_cast<boost::simd::pack<T, N>>((u ^ s) - s);
+}
+}
+
+/**
+ * absolute value key. signed integers compare by their magnitude as an
+ * unsigned value, so the smallest value is the largest magnitude.
+ */
+struct abs_key
+{
+    template <typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value, T>::type
+    key(T x)
+    {
+        return x < T(0) ? -x : x;
+    }
+
+    template <typename T, size_t N>
+    static typename std::enable_if<std::is_floating_point<T>::value,
+                                   boost::simd::pack<T, N>>::type
+    key(boost::simd::pack<T, N> x)
+    {
+        return boost::simd::abs(x);
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value, T>::type key(T x)
+    {
+        return std::is_signed<T>::value ? detail::flip_sign(detail::magnitude(x))
+                                        : x;
+    }
+
+    template <typename T, size_t N>
+    static typename std::enable_if<std::is_integral<T>::value,
+                                   boost::simd::pack<T, N>>::type
+    key(boost::simd::pack<T, N> x)
+    {
+        return std::is_signed<T>::value ? detail::flip_sign(detail::magnitude(x))
+                                        : x;
+    }
+
+    template <typename T> static T last()
+    {
+        return std::is_signed<T>::value && std::is_integral<T>::value
+                   ? std::numeric_limits<T>::min()
+                   : ascending::sentinel<T>();
+    }
+};
+
+/**
+ * unsigned key of a signed integer, e.g. to order ids stored in signed
+ * columns as unsigned. negative keys sort after the positive ones.
+ */
+struct unsigned_key
+{
+    template <typename T> static T key(T x)
+    {
+        return std::is_signed<typename boost::simd::meta::scalar_of<T>::type>::value
+                   ? detail::flip_sign(x)
+                   : x;
+    }
+
+    template <typename T> static T last()
+    {
+        return std::is_signed<T>::value ? T(-1) : std::numeric_limits<T>::max();
+    }
+};
+
+/**
+ * sorts by absolute value.
+ */
+using by_abs = key_order<abs_key>;
+
+/**
+ * sorts signed integers in unsigned order.
+ */
+using as_unsigned = key_order<unsigned_key>;
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+
+#include <floki/aa_sort.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/parallel_for.hpp>
+#include <floki/detail/parallel.hpp>
+}
+
+/**
+ * sorts vector in place using AA sort algorithm on multiple threads.
+ *
+ * the input is split into one part per thread and each part is sorted with
+ * floki::sort. the sorted parts are then merged pairwise. each merge pass is
+ * split along merge path diagonals so that all threads stay busy in the last
+ * passes, where only a few large runs are left.
+ */
+template <class RandomAccessIterator>
+inline void parallel_sort(RandomAccessIterator first, RandomAccessIterator last,
+                          unsigned threads = std::thread::hardware_concurrency())
+{
+    using boost::simd::allocator;
+
+    typedef typename RandomAccessIterator::value_type value_type;
+
+    using vector_t = std::vector<value_type, allocator<value_type>>;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    const size_t elements = std::distance(first, last);
+
+    threads = detail::parallel_threads(elements, threads);
+
+    if (threads == 1) {
+        floki::sort(first, last);
+        return;
+    }
+
+    std::vector<size_t> bounds(threads + 1);
+    for (unsigned t = 0; t <= threads; ++t) {
+        bounds[t] = detail::split_point(elements, threads, t);
+    }
+
+    // block sort and the cache resident merge passes for each part
+    detail::parallel_for(threads, [&](unsigned t) {
+        floki::sort(first + bounds[t], first + bounds[t + 1]);
+    });
+
+    vector_t temp(elements);
+    bool in_temp = false;
+
+    while (bounds.size() > 2) {
+        if (in_temp) {
+            detail::parallel_merge_pass<lanes>(begin(temp), first, bounds, threads);
+        } else {
+            detail::parallel_merge_pass<lanes>(first, begin(temp), bounds, threads);
+        }
+        in_temp = !in_temp;
+
+        std::vector<size_t> merged;
+        for (size_t r = 0; r < bounds.size(); r += 2) {
+            merged.push_back(bounds[r]);
+        }
+        if (merged.back() != elements) {
+            merged.push_back(elements);
+        }
+        bounds.swap(merged);
+    }
+
+    if (in_temp) {
+        detail::parallel_for(threads, [&](unsigned t) {
+            size_t begin = detail::split_point(elements, threads, t);
+            size_t end = detail::split_point(elements, threads, t + 1);
+            std::copy(temp.begin() + begin, temp.begin() + end, first + begin);
+        });
+    }
+}
+};
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <floki/aa_sort.hpp>
+
+#include <boost/simd/include/functions/splat.hpp>
+#include <boost/simd/include/functions/hmsb.hpp>
+#include <boost/simd/include/functions/ffs.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/select.hpp>
+}
+
+/**
+ * running k smallest values of a stream.
+ * the k smallest values seen so far are kept sorted, and the largest of them
+ * is the threshold a new value has to beat. pushed values are compared
+ * against the threshold a vector at a time, so once the buffer is full most
+ * of the input is discarded without being copied. the candidates are
+ * collected in a batch, sorted with the AA sort block and merge kernels and
+ * merged into the k smallest, which lowers the threshold.
+ */
+template <typename T>
+class top_k_stream
+{
+public:
+    explicit top_k_stream(size_t k)
+        : k_(k), batch_(std::max(k, size_t(1024))), best_(k + batch_),
+          merged_(k + batch_), candidates_(batch_), scratch_(batch_),
+          best_count_(0), candidate_count_(0)
+    {
+    }
+
+    /**
+     * adds the values of [first, last) to the stream.
+     */
+    template <class RandomAccessIterator>
+    void push(RandomAccessIterator first, RandomAccessIterator last)
+    {
+        const size_t lanes = detail::sort_lanes<T>::value;
+
+        size_t remaining = std::distance(first, last);
+        while (remaining && k_) {
+            // a slice never produces more candidates than there is room for
+            size_t slice = std::min(remaining, batch_ - candidate_count_);
+
+            if (best_count_ < k_) {
+                std::copy(first, first + slice,
+                          begin(candidates_) + candidate_count_);
+                candidate_count_ += slice;
+            } else {
+                candidate_count_ += detail::copy_less<lanes>(
+                    first, slice, best_[k_ - 1],
+                    begin(candidates_) + candidate_count_);
+            }
+
+            first += slice;
+            remaining -= slice;
+
+            if (candidate_count_ >= batch_ / 2) {
+                flush();
+            }
+        }
+    }
+
+    /**
+     * returns the k smallest values pushed so far in ascending order, or all
+     * of them if less than k were pushed.
+     */
+    std::vector<T> values()
+    {
+        flush();
+        return std::vector<T>(begin(best_), begin(best_) + best_count_);
+    }
+
+private:
+    void flush()
+    {
+        if (!candidate_count_) {
+            return;
+        }
+
+        const size_t lanes = detail::sort_lanes<T>::value;
+
+        auto candidates_first = begin(candidates_);
+        detail::sort_range(candidates_first,
+                           candidates_first + candidate_count_,
+                           begin(scratch_));
+
+        detail::merge_n<lanes>(begin(best_), best_count_, candidates_first,
+                               candidate_count_, begin(merged_));
+
+        best_.swap(merged_);
+        best_count_ = std::min(k_, best_count_ + candidate_count_);
+        candidate_count_ = 0;
+    }
+
+    using vector_t = std::vector<T, boost::simd::allocator<T>>;
+
+    size_t k_;
+    size_t batch_;
+    vector_t best_;
+    vector_t merged_;
+    vector_t candidates_;
+    vector_t scratch_;
+    size_t best_count_;
+    size_t candidate_count_;
+};
+
+/**
+ * returns the k smallest values of [first, last) in ascending order.
+ * the input is not modified.
+ */
+template <class RandomAccessIterator>
+inline std::vector<typename RandomAccessIterator::value_type>
+top_k(RandomAccessIterator first, RandomAccessIterator last, size_t k)
+{
+    top_k_stream<typename RandomAccessIterator::value_type> stream(k);
+    stream.push(first, last);
+    return stream.values();
+}
+
+/**
+ * same contract as std::partial_sort. [first, middle) holds the
+ * middle - first smallest values in ascending order and [middle, last) the
+ * rest in unspecified order.
+ * the smallest values are found with top_k, then the range is partitioned
+ * around the largest of them so the rest ends up after middle.
+ */
+template <class RandomAccessIterator>
+inline void partial_sort(RandomAccessIterator first,
+                         RandomAccessIterator middle,
+                         RandomAccessIterator last)
+{
+    if (first == middle) {
+        return;
+    }
+
+    auto smallest = top_k(first, last, std::distance(first, middle));
+
+    detail::partition_around(first, last, smallest.back());
+    std::copy(begin(smallest), end(smallest), first);
+}
+
+/**
+ * same contract as std::nth_element. nth holds the value it would hold if
+ * [first, last) was sorted, no element before it is greater and no element
+ * after it is less.
+ * for nth in the first quarter the value is found with top_k and the range
+ * partitioned around it, otherwise the range is sorted.
+ */
+template <class RandomAccessIterator>
+inline void nth_element(RandomAccessIterator first, RandomAccessIterator nth,
+                        RandomAccessIterator last)
+{
+    if (nth == last) {
+        return;
+    }
+
+    size_t k = std::distance(first, nth) + 1;
+
+    if (k > size_t(std::distance(first, last)) / 4) {
+        floki::sort(first, last);
+        return;
+    }
+
+    top_k_stream<typename RandomAccessIterator::value_type> stream(k);
+    stream.push(first, last);
+
+    detail::partition_around(first, last, stream.values().back());
+}
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include <boost/simd/include/pack.hpp>
+#include <boost/simd/include/functions/splat.hpp>
+#include <boost/simd/include/functions/simd/bitwise_cast.hpp>
+#include <boost/simd/memory/input_iterator.hpp>
+
+#include <floki/sort_stats.hpp>
+#include <floki/sort_workspace.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/radix.hpp>
+}
+
+/**
+ * sorts vector in place using LSD radix sort with 8 bit digits.
+ *
+ * the digits of all passes are counted in one vectorized read pass, then
+ * every pass scatters through per bucket cache line buffers. floating point
+ * keys are sorted by their bits with the sign flipped. floki::sort switches
+ * to radix_sort for large inputs.
+ */
+template <class RandomAccessIterator>
+inline void radix_sort(RandomAccessIterator first, RandomAccessIterator last,
+                       sort_workspace<typename RandomAccessIterator::value_type>
+                           &workspace)
+{
+    auto elements = std::distance(first, last);
+
+    workspace.reserve(elements);
+    detail::radix_sort_range(first, last, workspace.scratch(elements));
+}
+
+template <class RandomAccessIterator>
+inline void radix_sort(RandomAccessIterator first, RandomAccessIterator last)
+{
+    sort_workspace<typename RandomAccessIterator::value_type> workspace;
+
+    radix_sort(first, last, workspace);
+}
+};
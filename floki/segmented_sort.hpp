@@ -0,0 +1,65 @@
+#pragma once
+
+#include <floki/parallel_sort.hpp>
+#include <floki/static_sort.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/segmented.hpp>
+}
+
+/**
+ * sorts each of num_segments independent segments of data in place.
+ * segment s is [data + offsets[s], data + offsets[s + 1]), so offsets holds
+ * num_segments + 1 ascending positions.
+ *
+ * segments of up to 16 values are sorted lanes at a time, each in its own
+ * lane of one column sorting network. longer segments are sorted with
+ * floki::sort on a workspace shared by all of them, so no segment allocates.
+ * the segments are split across threads by the number of values in them.
+ */
+template <class RandomAccessIterator, class OffsetIterator>
+inline void segmented_sort(RandomAccessIterator data, OffsetIterator offsets,
+                           size_t num_segments,
+                           unsigned threads = std::thread::hardware_concurrency())
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    if (!num_segments) {
+        return;
+    }
+
+    const size_t first_offset = offsets[0];
+    const size_t elements = offsets[num_segments] - first_offset;
+
+    threads = detail::parallel_threads(elements, threads);
+
+    if (threads == 1) {
+        sort_workspace<value_type> workspace;
+        detail::sort_segments<lanes>(data, offsets, 0, num_segments,
+                                     workspace);
+        return;
+    }
+
+    // thread t sorts the segments that start in its part of the values
+    std::vector<size_t> bounds(threads + 1);
+    for (unsigned t = 0; t <= threads; ++t) {
+        bounds[t] = std::lower_bound(offsets, offsets + num_segments,
+                                     first_offset + elements * t / threads)
+                    - offsets;
+    }
+    bounds[threads] = num_segments;
+
+    detail::parallel_for(threads, [&](unsigned t) {
+        sort_workspace<value_type> workspace;
+        detail::sort_segments<lanes>(data, offsets, bounds[t], bounds[t + 1],
+                                     workspace);
+    });
+}
+};
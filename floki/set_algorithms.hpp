@@ -0,0 +1,135 @@
+#pragma once
+
+#include <functional>
+
+#include <floki/aa_sort.hpp>
+#include <floki/algorithms.hpp>
+
+#include <boost/simd/include/functions/hmsb.hpp>
+#include <boost/simd/include/functions/ffs.hpp>
+#include <boost/simd/include/functions/simd/is_equal.hpp>
+#include <boost/simd/include/functions/simd/is_not_equal.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/set.hpp>
+}
+
+/**
+ * writes the elements of the sorted set [first1, last1) that are also in the
+ * sorted set [first2, last2) to out and returns the end of the output, like
+ * std::set_intersection.
+ *
+ * the ranges are sets, e.g. posting lists of ids, sorted ascending without
+ * duplicates, in contiguous memory. a vector of each range is compared all
+ * pairs, lanes x lanes values in lanes compares, and the matching lanes are
+ * written out. when one range is more than 32 times longer than the other,
+ * each element of the short range is galloped to in the long one instead.
+ */
+template <class InputIterator1, class InputIterator2, class OutputIterator>
+inline OutputIterator set_intersection(InputIterator1 first1,
+                                       InputIterator1 last1,
+                                       InputIterator2 first2,
+                                       InputIterator2 last2,
+                                       OutputIterator out)
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type
+        value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    const size_t a_elements = std::distance(first1, last1);
+    const size_t b_elements = std::distance(first2, last2);
+
+    if (!a_elements || !b_elements) {
+        return out;
+    }
+
+    if (detail::gallop_ranges(a_elements, b_elements)) {
+        if (a_elements < b_elements) {
+            return detail::gallop_intersection(&*first1, a_elements, &*first2,
+                                               b_elements, out);
+        }
+        return detail::gallop_intersection(&*first2, b_elements, &*first1,
+                                           a_elements, out);
+    }
+
+    return detail::intersect_n<lanes>(first1, a_elements, first2, b_elements,
+                                      out);
+}
+
+/**
+ * writes the elements of either of the sorted sets [first1, last1) and
+ * [first2, last2) to out and returns the end of the output, like
+ * std::set_union.
+ *
+ * the ranges are merged with the bitonic merge kernels of floki::merge, and
+ * an element in both ranges is dropped the second time as each merged group
+ * is stored. when one range is more than 32 times longer than the other, the
+ * elements of the long range between 2 elements of the short one are found
+ * by galloping and copied as a block.
+ */
+template <class InputIterator1, class InputIterator2, class OutputIterator>
+inline OutputIterator set_union(InputIterator1 first1, InputIterator1 last1,
+                                InputIterator2 first2, InputIterator2 last2,
+                                OutputIterator out)
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type
+        value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    const size_t a_elements = std::distance(first1, last1);
+    const size_t b_elements = std::distance(first2, last2);
+
+    if (a_elements && b_elements
+        && detail::gallop_ranges(a_elements, b_elements)) {
+        if (a_elements < b_elements) {
+            return detail::gallop_union(&*first1, a_elements, &*first2,
+                                        b_elements, out);
+        }
+        return detail::gallop_union(&*first2, b_elements, &*first1,
+                                    a_elements, out);
+    }
+
+    return detail::union_n<lanes>(first1, a_elements, first2, b_elements, out);
+}
+
+/**
+ * writes the elements of the sorted set [first1, last1) that are not in the
+ * sorted set [first2, last2) to out and returns the end of the output, like
+ * std::set_difference.
+ *
+ * the same all pairs compare as floki::set_intersection finds the elements
+ * to leave out, and galloping is used in the same cases.
+ */
+template <class InputIterator1, class InputIterator2, class OutputIterator>
+inline OutputIterator set_difference(InputIterator1 first1,
+                                     InputIterator1 last1,
+                                     InputIterator2 first2,
+                                     InputIterator2 last2, OutputIterator out)
+{
+    typedef typename std::iterator_traits<InputIterator1>::value_type
+        value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    const size_t a_elements = std::distance(first1, last1);
+    const size_t b_elements = std::distance(first2, last2);
+
+    if (!a_elements || !b_elements) {
+        return std::copy(first1, last1, out);
+    }
+
+    if (detail::gallop_ranges(a_elements, b_elements)) {
+        return detail::gallop_difference(&*first1, a_elements, &*first2,
+                                         b_elements, out);
+    }
+
+    return detail::difference_n<lanes>(first1, a_elements, first2, b_elements,
+                                       out);
+}
+};
@@ -0,0 +1,283 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(FLOKI_SORT_STATS)
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+/**
+ * per phase instrumentation of floki::sort.
+ *
+ * built with FLOKI_SORT_STATS defined, every phase of a sort, the block sort,
+ * each merge pass, the tail merge and the radix passes, records its wall time
+ * and, on Linux, the cycles, cache misses and branch mispredicts read through
+ * perf_event_open. without FLOKI_SORT_STATS the phases compile to nothing,
+ * no perf or system headers are included and sort_stats_scope records
+ * nothing.
+ *
+ * phases are recorded on the thread that made a sort_stats_scope:
+ *
+ * floki::sort_stats stats;
+ * {
+ *     floki::sort_stats_scope scope(stats);
+ *     floki::sort(begin(values), end(values));
+ * }
+ * for (auto &phase : stats.phases) ...
+ */
+#if defined(FLOKI_SORT_STATS)
+#define FLOKI_SORT_PHASE(name)                                                 \
+    ::floki::detail::phase_recorder floki_phase_recorder_(name)
+#else
+#define FLOKI_SORT_PHASE(name)
+#endif
+
+namespace floki
+{
+
+/**
+ * one phase of a sort. the counters are 0 when they could not be read.
+ */
+struct sort_phase
+{
+    const char *name;
+    double wall_ms;
+    uint64_t cycles;
+    uint64_t cache_misses;
+    uint64_t branch_misses;
+};
+
+/**
+ * the phases of the sorts run while a sort_stats_scope on it was alive, in
+ * the order they finished.
+ */
+struct sort_stats
+{
+    std::vector<sort_phase> phases;
+
+    /**
+     * false when perf_event_open is not available or not permitted, e.g. with
+     * a kernel.perf_event_paranoid above 2. the wall times are still valid.
+     */
+    bool counters = false;
+
+    /**
+     * total wall time of the phases called name.
+     */
+    double wall_ms(const char *name) const
+    {
+        double total = 0;
+        for (const auto &phase : phases) {
+            if (!std::strcmp(phase.name, name)) {
+                total += phase.wall_ms;
+            }
+        }
+        return total;
+    }
+
+    void clear() { phases.clear(); }
+};
+
+#if defined(FLOKI_SORT_STATS)
+namespace detail
+{
+
+/**
+ * cycles, cache misses and branch mispredicts of the calling thread, as one
+ * perf event group so the three are read together.
+ */
+class perf_counters
+{
+public:
+    static const size_t count = 3;
+
+    perf_counters() : m_fds{ -1, -1, -1 }
+    {
+#if defined(__linux__)
+        const uint64_t configs[count] = { PERF_COUNT_HW_CPU_CYCLES,
+                                          PERF_COUNT_HW_CACHE_MISSES,
+                                          PERF_COUNT_HW_BRANCH_MISSES };
+        for (size_t i = 0; i < count; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            m_fds[i] = static_cast<int>(
+                syscall(__NR_perf_event_open, &attr, 0, -1,
+                        i ? m_fds[0] : -1, 0));
+            if (m_fds[i] < 0) {
+                close_all();
+                return;
+            }
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+
+    ~perf_counters() { close_all(); }
+
+    bool available() const { return m_fds[0] >= 0; }
+
+    /**
+     * reads the counters into values, or zeros if they are not available.
+     */
+    void read(uint64_t (&values)[count]) const
+    {
+        std::fill(values, values + count, uint64_t(0));
+#if defined(__linux__)
+        if (available()) {
+            uint64_t group[1 + count];
+            if (::read(m_fds[0], group, sizeof(group)) == sizeof(group)) {
+                std::copy(group + 1, group + 1 + count, values);
+            }
+        }
+#endif
+    }
+
+private:
+    void close_all()
+    {
+#if defined(__linux__)
+        for (auto &fd : m_fds) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            fd = -1;
+        }
+#endif
+    }
+
+    int m_fds[count];
+};
+
+/**
+ * the stats and counters phases of this thread are recorded to, and the id
+ * of the sort_stats_scope that set them, 0 when no scope is alive.
+ */
+struct stats_target
+{
+    sort_stats *stats;
+    perf_counters *counters;
+    uint64_t scope;
+};
+
+inline stats_target &thread_stats_target()
+{
+    static thread_local stats_target target = { nullptr, nullptr, 0 };
+    return target;
+}
+
+/**
+ * a new scope id of this thread, never 0.
+ */
+inline uint64_t next_stats_scope()
+{
+    static thread_local uint64_t scope = 0;
+    return ++scope;
+}
+
+/**
+ * records the phase from its construction to its destruction, when the same
+ * sort_stats_scope was alive on this thread at both. a phase started before
+ * a scope was opened, or still running when its scope was closed, is not
+ * recorded.
+ */
+class phase_recorder
+{
+public:
+    explicit phase_recorder(const char *name)
+        : m_name(name), m_target(thread_stats_target())
+    {
+        if (m_target.stats) {
+            m_target.counters->read(m_start_counters);
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    phase_recorder(const phase_recorder &) = delete;
+    phase_recorder &operator=(const phase_recorder &) = delete;
+
+    ~phase_recorder()
+    {
+        // the scope, its stats and counters may be gone
+        if (!m_target.stats
+            || thread_stats_target().scope != m_target.scope) {
+            return;
+        }
+
+        auto end = std::chrono::steady_clock::now();
+        uint64_t end_counters[perf_counters::count];
+        m_target.counters->read(end_counters);
+
+        sort_phase phase;
+        phase.name = m_name;
+        phase.wall_ms = std::chrono::duration_cast<std::chrono::duration
+                                                   <double, std::milli>>(
+                            end - m_start).count();
+        phase.cycles = end_counters[0] - m_start_counters[0];
+        phase.cache_misses = end_counters[1] - m_start_counters[1];
+        phase.branch_misses = end_counters[2] - m_start_counters[2];
+        m_target.stats->phases.push_back(phase);
+    }
+
+private:
+    const char *m_name;
+    const stats_target m_target;
+    std::chrono::steady_clock::time_point m_start;
+    uint64_t m_start_counters[perf_counters::count];
+};
+}
+
+/**
+ * records the sort phases run on this thread into stats while alive. the
+ * perf counters are opened once per scope. scopes do not nest.
+ */
+class sort_stats_scope
+{
+public:
+    explicit sort_stats_scope(sort_stats &stats)
+    {
+        stats.counters = m_counters.available();
+        detail::thread_stats_target()
+            = { &stats, &m_counters, detail::next_stats_scope() };
+    }
+
+    sort_stats_scope(const sort_stats_scope &) = delete;
+    sort_stats_scope &operator=(const sort_stats_scope &) = delete;
+
+    ~sort_stats_scope()
+    {
+        detail::thread_stats_target() = { nullptr, nullptr, 0 };
+    }
+
+private:
+    detail::perf_counters m_counters;
+};
+#else
+class sort_stats_scope
+{
+public:
+    explicit sort_stats_scope(sort_stats &stats) { stats.counters = false; }
+
+    sort_stats_scope(const sort_stats_scope &) = delete;
+    sort_stats_scope &operator=(const sort_stats_scope &) = delete;
+};
+#endif
+};
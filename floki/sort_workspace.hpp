@@ -0,0 +1,157 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include <boost/simd/memory/allocator.hpp>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace floki
+{
+
+/**
+ * how much scratch memory a sort_workspace gives a sort of n elements.
+ * full sorts with n elements of scratch. half sorts each half of the input
+ * with n / 2 elements of scratch and then merges the halves, which costs one
+ * extra pass over half the data.
+ */
+enum class scratch_size { full, half };
+
+/**
+ * reusable scratch memory for floki::sort.
+ * the memory grows to the largest sort seen and is kept until the workspace
+ * is destroyed or released, so sorting many arrays does not allocate, and
+ * never zero fills, on every call.
+ * with huge_pages the memory is mapped with 2MB pages where the OS allows it,
+ * which cuts TLB misses on the strided merge passes of large sorts. it falls
+ * back to transparent huge pages, then to normal pages.
+ */
+template <typename T>
+class sort_workspace
+{
+public:
+    explicit sort_workspace(scratch_size size = scratch_size::full,
+                            bool huge_pages = false)
+        : size_(size), huge_pages_(huge_pages), data_(nullptr), capacity_(0),
+          mapped_bytes_(0)
+    {
+    }
+
+    sort_workspace(const sort_workspace &) = delete;
+    sort_workspace &operator=(const sort_workspace &) = delete;
+
+    sort_workspace(sort_workspace &&other)
+        : size_(other.size_), huge_pages_(other.huge_pages_),
+          data_(other.data_), capacity_(other.capacity_),
+          mapped_bytes_(other.mapped_bytes_)
+    {
+        other.data_ = nullptr;
+        other.capacity_ = 0;
+        other.mapped_bytes_ = 0;
+    }
+
+    ~sort_workspace() { release(); }
+
+    scratch_size size() const { return size_; }
+
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * elements of scratch a sort of elements needs.
+     */
+    size_t required(size_t elements) const
+    {
+        return size_ == scratch_size::full ? elements : (elements + 1) / 2;
+    }
+
+    /**
+     * returns scratch memory for sorting elements, growing the workspace if
+     * it is too small. the memory is uninitialized.
+     */
+    T *scratch(size_t elements)
+    {
+        reserve(required(elements));
+        return data_;
+    }
+
+    /**
+     * grows the workspace to at least elements elements of scratch.
+     */
+    void reserve(size_t elements)
+    {
+        if (elements <= capacity_) {
+            return;
+        }
+        release();
+
+        if (huge_pages_) {
+            data_ = map(elements);
+        }
+        if (!data_) {
+            data_ = boost::simd::allocator<T>().allocate(elements);
+        }
+        capacity_ = elements;
+    }
+
+    /**
+     * frees the scratch memory.
+     */
+    void release()
+    {
+        if (!data_) {
+            return;
+        }
+#if defined(__linux__)
+        if (mapped_bytes_) {
+            munmap(data_, mapped_bytes_);
+        } else
+#endif
+        {
+            boost::simd::allocator<T>().deallocate(data_, capacity_);
+        }
+        data_ = nullptr;
+        capacity_ = 0;
+        mapped_bytes_ = 0;
+    }
+
+private:
+    T *map(size_t elements)
+    {
+#if defined(__linux__)
+        const size_t huge_page = 2 * 1024 * 1024;
+        size_t bytes = (elements * sizeof(T) + huge_page - 1) & ~(huge_page - 1);
+
+        void *p = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+        p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (p == MAP_FAILED) {
+            // no reserved huge pages, ask for transparent ones
+            p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                return nullptr;
+            }
+#if defined(MADV_HUGEPAGE)
+            madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+        }
+        mapped_bytes_ = bytes;
+        return static_cast<T *>(p);
+#else
+        return nullptr;
+#endif
+    }
+
+    scratch_size size_;
+    bool huge_pages_;
+    T *data_;
+    size_t capacity_;
+    size_t mapped_bytes_;
+};
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+
+#include <floki/aa_sort.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/static_sort.hpp>
+}
+
+/**
+ * sorts the N values starting at first, with N known at compile time.
+ *
+ * meant for many tiny arrays, such as 8 to 64 candidates per query. the
+ * values are loaded into registers and sorted with one unrolled bitonic
+ * network, with vectors narrow enough that little of it is padding. there is
+ * no scratch memory and no tail handling. Order is a sort order from
+ * floki/order.hpp.
+ *
+ * floki::static_sort<16>(begin(values));
+ */
+template <size_t N, class Order = ascending, class RandomAccessIterator>
+inline void static_sort(RandomAccessIterator first)
+{
+    static_assert(N > 0, "static_sort needs at least one value");
+
+    detail::static_sort_n<N, Order>(first);
+}
+
+template <class Order = ascending, class T, size_t N>
+inline void static_sort(std::array<T, N> &values)
+{
+    static_sort<N, Order>(values.begin());
+}
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <floki/set_algorithms.hpp>
+
+namespace floki
+{
+
+namespace detail
+{
+#include <floki/detail/unique.hpp>
+}
+
+/**
+ * removes all but the first of every run of equal elements of the sorted
+ * range [first, last) and returns the new end, like std::unique.
+ *
+ * a vector at a time is compared with its neighbors, one lane over, and the
+ * lanes that start a run are packed down to the output.
+ */
+template <class RandomAccessIterator>
+inline RandomAccessIterator unique(RandomAccessIterator first,
+                                   RandomAccessIterator last)
+{
+    typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+        value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    return detail::unique_n<lanes>(first, std::distance(first, last), first);
+}
+
+/**
+ * copies the first of every run of equal elements of the sorted range
+ * [first, last) to out and returns the end of the output, like
+ * std::unique_copy.
+ */
+template <class InputIterator, class OutputIterator>
+inline OutputIterator unique_copy(InputIterator first, InputIterator last,
+                                  OutputIterator out)
+{
+    typedef typename std::iterator_traits<InputIterator>::value_type
+        value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    return detail::unique_n<lanes>(first, std::distance(first, last), out);
+}
+
+/**
+ * sorts [first, last) and removes duplicates, returning the new end. the
+ * same as floki::sort followed by floki::unique without the extra pass.
+ *
+ * the two halves of the range are sorted with floki::sort, and the last
+ * merge, of the halves, drops the duplicates as it stores each merged group.
+ * the first half is moved to the workspace for the merge.
+ */
+template <class RandomAccessIterator>
+inline RandomAccessIterator
+sort_unique(RandomAccessIterator first, RandomAccessIterator last,
+            sort_workspace<typename RandomAccessIterator::value_type> &workspace)
+{
+    typedef typename RandomAccessIterator::value_type value_type;
+
+    const size_t lanes = detail::sort_lanes<value_type>::value;
+
+    const size_t elements = std::distance(first, last);
+    if (elements < 2) {
+        return last;
+    }
+
+    const size_t a_elements = elements / 2;
+    auto middle = first + a_elements;
+
+    sort(first, middle, workspace);
+    sort(middle, last, workspace);
+
+    auto temp = workspace.scratch(elements);
+    std::copy(first, middle, temp);
+
+    return detail::union_n<lanes>(temp, a_elements, middle,
+                                  elements - a_elements, first);
+}
+
+template <class RandomAccessIterator>
+inline RandomAccessIterator sort_unique(RandomAccessIterator first,
+                                        RandomAccessIterator last)
+{
+    sort_workspace<typename RandomAccessIterator::value_type> workspace;
+
+    return sort_unique(first, last, workspace);
+}
+};
@@ -0,0 +1,119 @@
+// picks the instruction set level of the floki kernels once, on first use.
+// built for the baseline of the fleet, it only runs cpuid and forwards to
+// the kernels of the level.
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <floki/dispatch.hpp>
+
+extern "C" {
+const floki::dispatch::kernels *floki_kernels_sse4();
+const floki::dispatch::kernels *floki_kernels_avx2();
+const floki::dispatch::kernels *floki_kernels_avx512();
+}
+
+namespace floki
+{
+namespace dispatch
+{
+
+namespace
+{
+
+const isa levels[] = { isa::sse4, isa::avx2, isa::avx512 };
+
+/**
+ * the level named by the FLOKI_ISA environment variable, or the highest
+ * level the cpu supports. sse4 is the lowest level floki is built for, a cpu
+ * without it runs no level.
+ */
+isa pick()
+{
+    if (!supported(isa::sse4)) {
+        throw std::runtime_error(
+            "floki::dispatch: cpu does not support sse4.2");
+    }
+
+    const char *requested = std::getenv("FLOKI_ISA");
+
+    isa best = isa::sse4;
+    for (isa level : levels) {
+        if (!supported(level)) {
+            continue;
+        }
+        if (requested && !std::strcmp(requested, name(level))) {
+            return level;
+        }
+        best = level;
+    }
+    return best;
+}
+}
+
+bool supported(isa level)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    // every feature the -m flags of the level in src/CMakeLists.txt enable,
+    // each level builds on the one below
+    switch (level) {
+    case isa::sse4:
+        return __builtin_cpu_supports("sse4.2")
+               && __builtin_cpu_supports("popcnt");
+    case isa::avx2:
+        return supported(isa::sse4) && __builtin_cpu_supports("avx2")
+               && __builtin_cpu_supports("fma");
+    case isa::avx512:
+        return supported(isa::avx2) && __builtin_cpu_supports("avx512f")
+               && __builtin_cpu_supports("avx512bw");
+    }
+#endif
+    // without cpuid the cpu is assumed to run the lowest level.
+    return level == isa::sse4;
+}
+
+const kernels &kernels_for(isa level)
+{
+    if (!supported(level)) {
+        throw std::invalid_argument(
+            std::string("floki::dispatch: cpu does not support ") + name(level));
+    }
+
+    switch (level) {
+    case isa::avx512:
+        return *floki_kernels_avx512();
+    case isa::avx2:
+        return *floki_kernels_avx2();
+    default:
+        return *floki_kernels_sse4();
+    }
+}
+
+isa selected()
+{
+    static const isa level = pick();
+    return level;
+}
+
+const char *name(isa level)
+{
+    switch (level) {
+    case isa::avx512:
+        return "avx512";
+    case isa::avx2:
+        return "avx2";
+    default:
+        return "sse4";
+    }
+}
+
+const kernels &active()
+{
+    static const kernels &level_kernels = kernels_for(selected());
+    return level_kernels;
+}
+}
+};
@@ -0,0 +1,78 @@
+// the floki kernels of one instruction set level. built once per level with
+// FLOKI_ISA set to the level and the matching -m flags, see CMakeLists.txt.
+
+#include <functional>
+
+#include <floki/aa_sort.hpp>
+#include <floki/algorithms.hpp>
+#include <floki/kary_search.hpp>
+#include <floki/dispatch.hpp>
+
+#ifndef FLOKI_ISA
+#error "FLOKI_ISA must name the instruction set level, e.g. -DFLOKI_ISA=avx2"
+#endif
+
+#define FLOKI_CONCAT_(a, b) a##b
+#define FLOKI_CONCAT(a, b) FLOKI_CONCAT_(a, b)
+
+#if defined(__GNUC__)
+#define FLOKI_EXPORT __attribute__((visibility("default")))
+#else
+#define FLOKI_EXPORT
+#endif
+
+namespace
+{
+
+template <typename T> void sort_kernel(T *first, T *last)
+{
+    floki::sort(first, last);
+}
+
+template <typename T>
+const T *find_greater_equal_kernel(const T *first, const T *last, T value)
+{
+    using std::placeholders::_1;
+    return floki::find_if(first, last,
+                          std::bind(floki::greater_equal(), _1, value));
+}
+
+template <typename T>
+uint32_t bfs_search_kernel(const T *begin, const T *end, T key, uint32_t k)
+{
+    switch (k) {
+    case 3:
+        return floki::bfs::search<T, 3>(begin, end, key);
+    case 5:
+        return floki::bfs::search<T, 5>(begin, end, key);
+    case 9:
+        return floki::bfs::search<T, 9>(begin, end, key);
+    default:
+        return floki::bfs::search<T, 17>(begin, end, key);
+    }
+}
+
+const floki::dispatch::kernels table = {
+    floki::dispatch::isa::FLOKI_ISA,
+
+    &sort_kernel<int32_t>,
+    &sort_kernel<uint32_t>,
+    &sort_kernel<int64_t>,
+    &sort_kernel<uint64_t>,
+    &sort_kernel<float>,
+    &sort_kernel<double>,
+
+    &find_greater_equal_kernel<int32_t>,
+    &find_greater_equal_kernel<uint32_t>,
+    &find_greater_equal_kernel<float>,
+
+    &bfs_search_kernel<int32_t>,
+    &bfs_search_kernel<float>,
+};
+}
+
+extern "C" FLOKI_EXPORT const floki::dispatch::kernels *
+FLOKI_CONCAT(floki_kernels_, FLOKI_ISA)()
+{
+    return &table;
+}
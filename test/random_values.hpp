@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+/**
+ * elements values drawn uniformly from [min_value, max_value] by a
+ * std::mt19937 seeded with seed, so a test sees the same values on every run.
+ * integers are drawn as 64 bit values, uniform_int_distribution is not
+ * defined for 8 bit types.
+ */
+template <typename element_type>
+std::vector<element_type> random_values(size_t elements,
+                                        element_type min_value,
+                                        element_type max_value, uint32_t seed)
+{
+    using draw_t = typename std::conditional
+        <!std::is_integral<element_type>::value, element_type,
+         typename std::conditional<std::is_signed<element_type>::value,
+                                   int64_t, uint64_t>::type>::type;
+    using distribution_t = typename std::conditional
+        <std::is_integral<element_type>::value,
+         std::uniform_int_distribution<draw_t>,
+         std::uniform_real_distribution<draw_t>>::type;
+
+    std::vector<element_type> values(elements);
+    std::mt19937 engine(seed);
+    distribution_t distribution(min_value, max_value);
+    std::generate(begin(values), end(values),
+                  [&] { return element_type(distribution(engine)); });
+    return values;
+}
+
+/**
+ * random_values sorted ascending.
+ */
+template <typename element_type>
+std::vector<element_type> sorted_random_values(size_t elements,
+                                               element_type min_value,
+                                               element_type max_value,
+                                               uint32_t seed)
+{
+    auto values = random_values(elements, min_value, max_value, seed);
+    std::sort(begin(values), end(values));
+    return values;
+}
@@ -5,6 +5,7 @@ using namespace bandit;
 #include <limits>
 #include <vector>
 #include <random>
+#include <numeric>
 #include <floki/aa_sort.hpp>
 #include <boost/simd/memory/input_iterator.hpp>
 #include <boost/simd/memory/output_iterator.hpp>
@@ -41,6 +42,225 @@ template <typename element_type> void random_test(size_t elements = 16 * 256)
     AssertThat(values, EqualsContainer(sorted_values));
 }
 
+template <typename key_type, typename value_type>
+void random_key_value_test(size_t elements = 16 * 256)
+{
+    std::vector<key_type> keys(elements);
+    using distribution_t = typename std::conditional
+        <std::is_integral<key_type>::value,
+         typename std::uniform_int_distribution<key_type>,
+         typename std::uniform_real_distribution<key_type>>::type;
+    distribution_t distribution(0, 1000);
+    std::mt19937 engine;
+    auto generator = std::bind(distribution, engine);
+    std::generate_n(keys.begin(), elements, generator);
+
+    std::vector<value_type> values(elements);
+    std::iota(begin(values), end(values), 0);
+
+    auto original_keys = keys;
+    auto sorted_keys = keys;
+    std::sort(begin(sorted_keys), end(sorted_keys));
+
+    floki::sort_by_key(begin(keys), end(keys), begin(values));
+
+    AssertThat(keys, EqualsContainer(sorted_keys));
+
+    // every value still travels with its key
+    for (size_t i = 0; i < elements; ++i) {
+        AssertThat(original_keys[values[i]], Equals(keys[i]));
+    }
+
+    std::sort(begin(values), end(values));
+    for (size_t i = 0; i < elements; ++i) {
+        AssertThat(values[i], Equals(value_type(i)));
+    }
+}
+
+template <typename element_type> void argsort_test(size_t elements = 16 * 256)
+{
+    std::vector<element_type> values(elements);
+    using distribution_t = typename std::conditional
+        <std::is_integral<element_type>::value,
+         typename std::uniform_int_distribution<element_type>,
+         typename std::uniform_real_distribution<element_type>>::type;
+    distribution_t distribution;
+    std::mt19937 engine;
+    auto generator = std::bind(distribution, engine);
+    std::generate_n(values.begin(), elements, generator);
+
+    auto original_values = values;
+    auto sorted_values = values;
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    std::vector<uint32_t> indices = floki::argsort(begin(values), end(values));
+
+    AssertThat(values, EqualsContainer(original_values));
+    AssertThat(indices.size(), Equals(elements));
+
+    std::vector<element_type> gathered(elements);
+    for (size_t i = 0; i < elements; ++i) {
+        gathered[i] = values[indices[i]];
+    }
+    AssertThat(gathered, EqualsContainer(sorted_values));
+
+    std::sort(begin(indices), end(indices));
+    for (size_t i = 0; i < elements; ++i) {
+        AssertThat(indices[i], Equals(uint32_t(i)));
+    }
+}
+
+template <typename element_type, size_t lanes> void block_sort_test()
+{
+    using pack_t = pack<element_type, lanes>;
+    const size_t vectors = floki::detail::block_vectors<lanes>::value;
+
+    std::vector<element_type> values(lanes * vectors);
+    std::uniform_int_distribution<int32_t> distribution(0, 100);
+    std::mt19937 engine(lanes);
+    std::generate(begin(values), end(values),
+                  [&] { return element_type(distribution(engine)); });
+
+    auto sorted_values = values;
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    pack_t block[vectors];
+    auto in = input_begin<lanes>(begin(values));
+    for (size_t i = 0; i < vectors; ++i) {
+        block[i] = *in++;
+    }
+
+    floki::detail::bitonic_sort_block(block);
+
+    auto out = output_begin<lanes>(begin(values));
+    for (size_t i = 0; i < vectors; ++i) {
+        *out++ = block[i];
+    }
+
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
+// uniform_int_distribution is not defined for 8 bit types
+template <typename element_type> void narrow_random_test(size_t elements)
+{
+    std::vector<element_type> values(elements);
+    std::uniform_int_distribution<int32_t> distribution(
+        std::numeric_limits<element_type>::min(),
+        std::numeric_limits<element_type>::max());
+    std::mt19937 engine;
+    std::generate(begin(values), end(values),
+                  [&] { return element_type(distribution(engine)); });
+
+    auto sorted_values = values;
+
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    floki::sort(begin(values), end(values));
+
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
+template <size_t lanes> void wide_merge_sort_test()
+{
+    std::vector<int32_t> values(10 * lanes);
+    std::uniform_int_distribution<int32_t> distribution(0, 1000);
+    std::mt19937 engine(lanes);
+    std::generate(begin(values), end(values),
+                  [&] { return distribution(engine); });
+    std::sort(begin(values), begin(values) + 6 * lanes);
+    std::sort(begin(values) + 6 * lanes, end(values));
+
+    auto sorted_values = values;
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    auto output_values = values;
+
+    floki::detail::merge_sort(input_begin<lanes>(begin(values)),
+                              input_begin<lanes>(begin(values) + 6 * lanes),
+                              output_begin<lanes>(begin(output_values)), 6, 4);
+
+    AssertThat(output_values, EqualsContainer(sorted_values));
+}
+
+template <size_t lanes, size_t width> void merge_sort_width_test()
+{
+    std::vector<int32_t> values(24 * lanes);
+    std::uniform_int_distribution<int32_t> distribution(0, 1000);
+    std::mt19937 engine(width);
+    std::generate(begin(values), end(values),
+                  [&] { return distribution(engine); });
+    std::sort(begin(values), begin(values) + 16 * lanes);
+    std::sort(begin(values) + 16 * lanes, end(values));
+
+    auto sorted_values = values;
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    auto output_values = values;
+
+    floki::detail::merge_sort_width<width>(
+        input_begin<lanes>(begin(values)),
+        input_begin<lanes>(begin(values) + 16 * lanes),
+        output_begin<lanes>(begin(output_values)), 16, 8);
+
+    AssertThat(output_values, EqualsContainer(sorted_values));
+}
+
+template <typename element_type>
+void workspace_test(floki::sort_workspace<element_type> &workspace,
+                    size_t elements)
+{
+    std::vector<element_type> values(elements);
+    std::mt19937 engine(static_cast<uint32_t>(elements));
+    std::uniform_int_distribution<element_type> distribution(0, 1000);
+    std::generate(begin(values), end(values), [&] { return distribution(engine); });
+
+    auto sorted_values = values;
+
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    floki::sort(begin(values), end(values), workspace);
+
+    AssertThat(values, EqualsContainer(sorted_values));
+    AssertThat(workspace.capacity() >= workspace.required(elements), IsTrue());
+}
+
+template <typename Order, typename element_type>
+void order_test(size_t elements, bool half_scratch = false)
+{
+    std::vector<element_type> values(elements);
+    std::mt19937 engine(static_cast<uint32_t>(elements));
+    // uniform_int_distribution is not defined for 8 bit types
+    typedef typename std::conditional
+        <sizeof(element_type) == 1, int32_t, element_type>::type draw_t;
+    using distribution_t = typename std::conditional
+        <std::is_integral<element_type>::value,
+         typename std::uniform_int_distribution<draw_t>,
+         typename std::uniform_real_distribution<element_type>>::type;
+    distribution_t distribution(
+        draw_t(std::is_signed<element_type>::value ? -100 : 0), draw_t(100));
+    std::generate(begin(values), end(values),
+                  [&] { return static_cast<element_type>(distribution(engine)); });
+    if (elements > 2) {
+        values[0] = std::numeric_limits<element_type>::max();
+        values[1] = std::numeric_limits<element_type>::lowest();
+    }
+
+    auto sorted_values = values;
+
+    floki::sort_workspace<element_type> workspace(
+        half_scratch ? floki::scratch_size::half : floki::scratch_size::full);
+    floki::sort<Order>(begin(values), end(values), workspace);
+
+    AssertThat(std::is_sorted(begin(values), end(values),
+                              Order::template less<element_type>),
+               IsTrue());
+
+    // same values, ties of the order may come in any order
+    std::sort(begin(values), end(values));
+    std::sort(begin(sorted_values), end(sorted_values));
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
 // snowhouse container equality check.  For unit testing only
 template <typename pack_t>
 static bool are_packs_equal(const pack_t &lhs, const pack_t &rhs)
@@ -240,6 +460,232 @@ go_bandit([]() {
         it("test sort random float", [&]() { random_test<float>(); });
 
         it("test sort random double", [&]() { random_test<double>(); });
+
+        it("test sort random double 1001",
+           [&]() { random_test<double>(1001); });
+
+        it("test sort random int64_t", [&]() { random_test<int64_t>(); });
+
+        it("test sort random int64_t 999",
+           [&]() { random_test<int64_t>(999); });
+
+        it("test sort random uint64_t", [&]() { random_test<uint64_t>(); });
+
+        it("test sort random int16_t",
+           [&]() { narrow_random_test<int16_t>(16 * 256); });
+
+        it("test sort random int16_t 1003",
+           [&]() { narrow_random_test<int16_t>(1003); });
+
+        it("test sort random uint16_t",
+           [&]() { narrow_random_test<uint16_t>(16 * 256); });
+
+        it("test sort random uint8_t",
+           [&]() { narrow_random_test<uint8_t>(16 * 256); });
+
+        it("test sort random uint8_t 777",
+           [&]() { narrow_random_test<uint8_t>(777); });
+
+        it("test sort random int8_t",
+           [&]() { narrow_random_test<int8_t>(16 * 256 + 5); });
+
+        it("test sort every length to 600", [&]() {
+            for (size_t elements = 0; elements <= 600; ++elements) {
+                random_test<int32_t>(elements);
+            }
+        });
+
+        it("test sort tail with equal values", [&]() {
+            std::vector<int32_t> values(16 * 64 + 7, 5);
+            values.back() = std::numeric_limits<int32_t>::max();
+            values[3] = std::numeric_limits<int32_t>::max();
+
+            auto sorted_values = values;
+            std::sort(begin(sorted_values), end(sorted_values));
+
+            floki::sort(begin(values), end(values));
+
+            AssertThat(values, EqualsContainer(sorted_values));
+        });
+
+        it("test sort descending", [&]() {
+            for (size_t elements : { 0, 5, 64, 100, 1000, 4096, 10007 }) {
+                order_test<floki::descending, int32_t>(elements);
+                order_test<floki::descending, float>(elements);
+            }
+        });
+
+        it("test sort descending narrow and wide", [&]() {
+            order_test<floki::descending, double>(3001);
+            order_test<floki::descending, int64_t>(3001);
+            order_test<floki::descending, uint16_t>(3001);
+            order_test<floki::descending, int8_t>(3001);
+        });
+
+        it("test sort descending half scratch", [&]() {
+            order_test<floki::descending, int32_t>(5003, true);
+        });
+
+        it("test sort by abs", [&]() {
+            for (size_t elements : { 7, 100, 1000, 4099 }) {
+                order_test<floki::by_abs, int32_t>(elements);
+                order_test<floki::by_abs, double>(elements);
+                order_test<floki::by_abs, int16_t>(elements);
+            }
+        });
+
+        it("test sort as unsigned", [&]() {
+            for (size_t elements : { 7, 100, 1000, 4099 }) {
+                order_test<floki::as_unsigned, int32_t>(elements);
+                order_test<floki::as_unsigned, int64_t>(elements);
+                order_test<floki::as_unsigned, int8_t>(elements);
+            }
+        });
+
+        it("test sort reused workspace", [&]() {
+            floki::sort_workspace<int32_t> workspace;
+            for (size_t elements : { 4096, 100, 5000, 17, 4096 }) {
+                workspace_test(workspace, elements);
+            }
+            AssertThat(workspace.capacity(), Equals(size_t(5000)));
+        });
+
+        it("test sort half scratch workspace", [&]() {
+            floki::sort_workspace<int32_t> workspace(floki::scratch_size::half);
+            for (size_t elements : { 4096, 4097, 1001, 33, 3, 1, 0 }) {
+                workspace_test(workspace, elements);
+            }
+            AssertThat(workspace.capacity(), Equals(size_t(2049)));
+        });
+
+        it("test sort huge page workspace", [&]() {
+            floki::sort_workspace<int64_t> workspace(floki::scratch_size::full,
+                                                     true);
+            workspace_test(workspace, 100000);
+            workspace.release();
+            AssertThat(workspace.capacity(), Equals(size_t(0)));
+            workspace_test(workspace, 999);
+        });
+
+        it("test key value bitonic sort", [&]() {
+
+            using pack_t = pack<int32_t, 4>;
+            using kv_t = floki::detail::key_value<pack_t>;
+
+            std::vector<kv_t> values{
+                floki::detail::make_key_value(pack_t{ 50, 40, 30, 20 },
+                                              pack_t{ 0, 1, 2, 3 }),
+                floki::detail::make_key_value(pack_t{ 10, 0, 60, 55 },
+                                              pack_t{ 4, 5, 6, 7 }),
+                floki::detail::make_key_value(pack_t{ 88, 22, 44, 96 },
+                                              pack_t{ 8, 9, 10, 11 }),
+                floki::detail::make_key_value(pack_t{ 24, 6, 4, 3 },
+                                              pack_t{ 12, 13, 14, 15 })
+            };
+
+            std::vector<pack_t> sorted_keys{ { 0, 3, 4, 6 },
+                                             { 10, 20, 22, 24 },
+                                             { 30, 40, 44, 50 },
+                                             { 55, 60, 88, 96 } };
+
+            std::vector<pack_t> sorted_values{ { 5, 15, 14, 13 },
+                                               { 4, 3, 9, 12 },
+                                               { 2, 1, 10, 0 },
+                                               { 7, 6, 8, 11 } };
+
+            tie(values[0], values[1], values[2], values[3])
+                = floki::detail::bitonic_sort_16(values[0], values[1],
+                                                 values[2], values[3]);
+
+            for (int i = 0; i < 4; ++i) {
+                AssertThat(are_packs_equal(values[i].key, sorted_keys[i]),
+                           IsTrue());
+                AssertThat(are_packs_equal(values[i].value, sorted_values[i]),
+                           IsTrue());
+            }
+        });
+
+        it("test sort by key random int32_t",
+           [&]() { random_key_value_test<int32_t, uint32_t>(); });
+
+        it("test sort by key random int32_t 1000",
+           [&]() { random_key_value_test<int32_t, uint32_t>(1000); });
+
+        it("test sort by key random int32_t 100",
+           [&]() { random_key_value_test<int32_t, uint32_t>(100); });
+
+        it("test sort by key random float",
+           [&]() { random_key_value_test<float, uint32_t>(4099); });
+
+        it("test transpose 8 lanes", [&]() {
+            using pack_t = pack<int32_t, 8>;
+
+            pack_t values[8];
+            for (int i = 0; i < 8; ++i) {
+                for (int j = 0; j < 8; ++j) {
+                    values[i][j] = i * 8 + j;
+                }
+            }
+
+            floki::detail::transpose_vectors(values, 8);
+
+            for (int i = 0; i < 8; ++i) {
+                for (int j = 0; j < 8; ++j) {
+                    AssertThat(values[i][j], Equals(j * 8 + i));
+                }
+            }
+        });
+
+        it("test bitmerge1 8 lanes", [&]() {
+            using pack_t = pack<int32_t, 8>;
+
+            pack_t values{ 1, 5, 9, 12, 11, 8, 4, 2 };
+            pack_t sorted_values{ 1, 2, 4, 5, 8, 9, 11, 12 };
+
+            AssertThat(are_packs_equal(floki::detail::bitmerge1(values),
+                                       sorted_values),
+                       IsTrue());
+        });
+
+        it("test bitonic sort block 4 lanes",
+           [&]() { block_sort_test<int32_t, 4>(); });
+
+        it("test bitonic sort block 8 lanes",
+           [&]() { block_sort_test<int32_t, 8>(); });
+
+        it("test bitonic sort block 16 lanes",
+           [&]() { block_sort_test<int32_t, 16>(); });
+
+        it("test bitonic sort block 2 lanes int64_t",
+           [&]() { block_sort_test<int64_t, 2>(); });
+
+        it("test bitonic sort block 4 lanes double",
+           [&]() { block_sort_test<double, 4>(); });
+
+        it("test bitonic sort block 8 lanes int16_t",
+           [&]() { block_sort_test<int16_t, 8>(); });
+
+        it("test bitonic sort block 16 lanes uint8_t",
+           [&]() { block_sort_test<uint8_t, 16>(); });
+
+        it("test merge sort 8 lanes", [&]() { wide_merge_sort_test<8>(); });
+
+        it("test merge sort 16 lanes", [&]() { wide_merge_sort_test<16>(); });
+
+        it("test merge sort widths", [&]() {
+            merge_sort_width_test<4, 2>();
+            merge_sort_width_test<4, 4>();
+            merge_sort_width_test<4, 8>();
+            merge_sort_width_test<8, 8>();
+        });
+
+        it("test argsort int32_t", [&]() { argsort_test<int32_t>(); });
+
+        it("test argsort int32_t 1001", [&]() { argsort_test<int32_t>(1001); });
+
+        it("test argsort float", [&]() { argsort_test<float>(); });
+
+        it("test argsort double", [&]() { argsort_test<double>(517); });
     });
 });
 int main(int argc, char *argv[])
@@ -0,0 +1,117 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+#include <random>
+#include <numeric>
+#include <floki/adaptive_sort.hpp>
+#include <boost/simd/memory/allocator.hpp>
+
+#include "random_values.hpp"
+
+template <typename element_type>
+void adaptive_test(std::vector<element_type> values)
+{
+    auto sorted_values = values;
+
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    floki::adaptive_sort(begin(values), end(values));
+
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
+go_bandit([]() {
+
+    describe("test adaptive sort", []() {
+
+        it("test run length", [&]() {
+            std::vector<int32_t> values(100);
+            std::iota(begin(values), end(values), 0);
+            values[37] = 0;
+
+            AssertThat(floki::detail::run_length<4>(begin(values), 100, false),
+                       Equals(size_t(37)));
+            AssertThat(floki::detail::run_length<4>(begin(values), 30, false),
+                       Equals(size_t(30)));
+            AssertThat(floki::detail::run_length<4>(begin(values) + 36, 5, true),
+                       Equals(size_t(2)));
+
+            std::vector<int32_t> descending{ 9, 9, 8, 7, 7, 7, 6, 5, 4, 3, 5 };
+            AssertThat(floki::detail::run_length<4>(begin(descending), 11, true),
+                       Equals(size_t(10)));
+        });
+
+        it("test find runs", [&]() {
+            std::vector<int32_t> values(10000);
+            std::iota(begin(values), begin(values) + 5000, 0);
+            std::iota(values.rbegin(), values.rbegin() + 3000, 0);
+            auto tail = random_values<int32_t>(2000, 0, 100, 1);
+            std::copy(begin(tail), end(tail), begin(values) + 5000);
+
+            // sort_range reads and writes temp with aligned vector loads
+            std::vector<int32_t, boost::simd::allocator<int32_t>> temp(1000);
+            auto bounds = floki::detail::find_runs(begin(values), end(values),
+                                                   begin(temp), 1000);
+
+            std::vector<size_t> expected{ 0, 5000, 6000, 7000, 10000 };
+            AssertThat(bounds, EqualsContainer(expected));
+            for (size_t r = 0; r + 1 < bounds.size(); ++r) {
+                AssertThat(std::is_sorted(begin(values) + bounds[r],
+                                          begin(values) + bounds[r + 1]),
+                           IsTrue());
+            }
+        });
+
+        it("test adaptive sort sorted", [&]() {
+            auto values = random_values<int32_t>(100000, 0, 1 << 30, 2);
+            std::sort(begin(values), end(values));
+            adaptive_test(values);
+        });
+
+        it("test adaptive sort reversed", [&]() {
+            auto values = random_values<int32_t>(100003, 0, 1000, 3);
+            std::sort(begin(values), end(values), std::greater<int32_t>());
+            adaptive_test(values);
+        });
+
+        it("test adaptive sort appended runs", [&]() {
+            auto values = random_values<int32_t>(90001, 0, 1 << 30, 4);
+            for (size_t r = 0; r < 5; ++r) {
+                std::sort(begin(values) + r * 18000,
+                          begin(values) + std::min((r + 1) * 18000, values.size()));
+            }
+            adaptive_test(values);
+        });
+
+        it("test adaptive sort mixed", [&]() {
+            auto values = random_values<int64_t>(50000, 0, 1 << 20, 5);
+            std::sort(begin(values), begin(values) + 20000);
+            std::sort(begin(values) + 30000, end(values), std::greater<int64_t>());
+            adaptive_test(values);
+        });
+
+        it("test adaptive sort random", [&]() {
+            adaptive_test(random_values<int32_t>(77777, 0, 1 << 30, 6));
+        });
+
+        it("test adaptive sort equal", [&]() {
+            adaptive_test(std::vector<int32_t>(20000, 3));
+        });
+
+        it("test adaptive sort small", [&]() {
+            for (size_t elements = 0; elements < 70; ++elements) {
+                adaptive_test(
+                    random_values<int32_t>(elements, 0, 50, elements));
+            }
+        });
+    });
+});
+
+int main(int argc, char *argv[])
+{
+    return bandit::run(argc, argv);
+}
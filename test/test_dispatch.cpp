@@ -0,0 +1,192 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <floki/dispatch.hpp>
+#include <floki/kary_search.hpp>
+
+// built once per instruction set level with FLOKI_TEST_ISA set to the level.
+// the kernels of a level the cpu does not run are not tested.
+
+using floki::dispatch::isa;
+
+const isa level = isa::FLOKI_TEST_ISA;
+
+void kernel_sort(const floki::dispatch::kernels &kernels, int32_t *first,
+                 int32_t *last)
+{
+    kernels.sort_int32(first, last);
+}
+
+void kernel_sort(const floki::dispatch::kernels &kernels, uint32_t *first,
+                 uint32_t *last)
+{
+    kernels.sort_uint32(first, last);
+}
+
+void kernel_sort(const floki::dispatch::kernels &kernels, int64_t *first,
+                 int64_t *last)
+{
+    kernels.sort_int64(first, last);
+}
+
+void kernel_sort(const floki::dispatch::kernels &kernels, uint64_t *first,
+                 uint64_t *last)
+{
+    kernels.sort_uint64(first, last);
+}
+
+void kernel_sort(const floki::dispatch::kernels &kernels, float *first,
+                 float *last)
+{
+    kernels.sort_float(first, last);
+}
+
+void kernel_sort(const floki::dispatch::kernels &kernels, double *first,
+                 double *last)
+{
+    kernels.sort_double(first, last);
+}
+
+template <typename element_type>
+void dispatch_sort_test(size_t elements)
+{
+    std::vector<element_type> values(elements);
+    std::mt19937 engine(elements);
+    std::uniform_int_distribution<int32_t> distribution(-100000, 100000);
+    std::generate(begin(values), end(values),
+                  [&] { return element_type(distribution(engine)); });
+
+    auto expected = values;
+    std::sort(begin(expected), end(expected));
+
+    kernel_sort(floki::dispatch::kernels_for(level), values.data(),
+                values.data() + values.size());
+
+    AssertThat(values, EqualsContainer(expected));
+}
+
+go_bandit([]() {
+
+    describe("test dispatch", []() {
+
+        it("test dispatch selected level is supported", [&]() {
+            AssertThat(floki::dispatch::supported(floki::dispatch::selected()),
+                       IsTrue());
+            AssertThat(floki::dispatch::active().level,
+                       Equals(floki::dispatch::selected()));
+        });
+
+        if (!floki::dispatch::supported(level)) {
+            std::cout << "cpu does not support " << floki::dispatch::name(level)
+                      << ", its kernels are not tested" << std::endl;
+
+            it("test dispatch unsupported level throws", [&]() {
+                bool thrown = false;
+                try {
+                    floki::dispatch::kernels_for(level);
+                } catch (const std::invalid_argument &) {
+                    thrown = true;
+                }
+                AssertThat(thrown, IsTrue());
+            });
+            return;
+        }
+
+        it("test dispatch kernels level", [&]() {
+            AssertThat(floki::dispatch::kernels_for(level).level,
+                       Equals(level));
+        });
+
+        it("test dispatch sort", [&]() {
+            for (size_t elements : { 0, 1, 17, 1000, 65537 }) {
+                dispatch_sort_test<int32_t>(elements);
+                dispatch_sort_test<uint32_t>(elements);
+                dispatch_sort_test<int64_t>(elements);
+                dispatch_sort_test<uint64_t>(elements);
+                dispatch_sort_test<float>(elements);
+                dispatch_sort_test<double>(elements);
+            }
+        });
+
+        it("test dispatch find greater equal", [&]() {
+            const auto &kernels = floki::dispatch::kernels_for(level);
+
+            std::vector<int32_t> values(1001);
+            std::iota(begin(values), end(values), -500);
+            std::vector<float> float_values(begin(values), end(values));
+            std::vector<uint32_t> unsigned_values(1001);
+            std::iota(begin(unsigned_values), end(unsigned_values), 0u);
+
+            for (int32_t value : { -1000, -500, -3, 0, 77, 500, 501 }) {
+                auto first = values.data();
+                auto last = first + values.size();
+                auto expected = std::lower_bound(first, last, value);
+                AssertThat(kernels.find_greater_equal_int32(first, last, value)
+                               == expected,
+                           IsTrue());
+
+                auto float_first = float_values.data();
+                auto float_last = float_first + float_values.size();
+                AssertThat(kernels.find_greater_equal_float(float_first,
+                                                            float_last,
+                                                            float(value))
+                               - float_first,
+                           Equals(expected - first));
+
+                // the same positions in [0, 1000], shifted up by 500
+                auto unsigned_first = unsigned_values.data();
+                auto unsigned_last = unsigned_first + unsigned_values.size();
+                uint32_t unsigned_value = uint32_t(std::max(value + 500, 0));
+                AssertThat(kernels.find_greater_equal_uint32(unsigned_first,
+                                                             unsigned_last,
+                                                             unsigned_value)
+                               - unsigned_first,
+                           Equals(std::lower_bound(unsigned_first,
+                                                   unsigned_last,
+                                                   unsigned_value)
+                                  - unsigned_first));
+            }
+        });
+
+        it("test dispatch bfs search", [&]() {
+            const auto &kernels = floki::dispatch::kernels_for(level);
+
+            for (uint32_t k : { 3, 5, 9, 17 }) {
+                // a complete tree of 3 levels
+                uint32_t N = k * k * k;
+                std::vector<int32_t> sorted_values(N - 1);
+                std::iota(begin(sorted_values), end(sorted_values), 0);
+                std::vector<int32_t> linearized(N - 1);
+                floki::bfs::linearize<int32_t>(&sorted_values[0], k, N,
+                                               &linearized[0]);
+
+                std::vector<float> float_linearized(begin(linearized),
+                                                    end(linearized));
+
+                for (int32_t key = 0; key < int32_t(N - 1); key += 7) {
+                    AssertThat(kernels.bfs_search_int32(&linearized[0],
+                                                        &linearized[N - 1],
+                                                        key, k),
+                               Equals(uint32_t(key)));
+                    AssertThat(kernels.bfs_search_float(
+                                   &float_linearized[0],
+                                   &float_linearized[N - 1], float(key), k),
+                               Equals(uint32_t(key)));
+                    AssertThat(kernels.bfs_search_float(
+                                   &float_linearized[0],
+                                   &float_linearized[N - 1], key - 0.5f, k),
+                               Equals(uint32_t(key)));
+                }
+            }
+        });
+    });
+
+});
+
+int main(int argc, char *argv[]) { return bandit::run(argc, argv); }
@@ -0,0 +1,96 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/external_sort.hpp>
+
+template <typename element_type>
+void write_file(const std::string &path, const std::vector<element_type> &values)
+{
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(values.data()),
+               values.size() * sizeof(element_type));
+}
+
+template <typename element_type>
+std::vector<element_type> read_file(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    std::vector<element_type> values(file.tellg() / sizeof(element_type));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(values.data()),
+              values.size() * sizeof(element_type));
+    return values;
+}
+
+template <typename element_type>
+void external_test(size_t elements, size_t memory_budget)
+{
+    std::vector<element_type> values(elements);
+    using distribution_t = typename std::conditional
+        <std::is_integral<element_type>::value,
+         typename std::uniform_int_distribution<element_type>,
+         typename std::uniform_real_distribution<element_type>>::type;
+    distribution_t distribution;
+    std::mt19937 engine(static_cast<uint32_t>(elements));
+    std::generate(begin(values), end(values), [&] { return distribution(engine); });
+
+    const std::string input_path = "floki_external_input.bin";
+    const std::string output_path = "floki_external_output.bin";
+    write_file(input_path, values);
+
+    floki::external_sort<element_type>(input_path, output_path, memory_budget);
+
+    std::sort(begin(values), end(values));
+    AssertThat(read_file<element_type>(output_path), EqualsContainer(values));
+
+    std::ifstream runs(output_path + ".runs");
+    AssertThat(runs.good(), IsFalse());
+
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+}
+
+go_bandit([]() {
+
+    describe("test external sort", []() {
+
+        it("test external sort many runs", [&]() {
+            external_test<int32_t>(1000003, 64 * 1024);
+        });
+
+        it("test external sort float", [&]() {
+            external_test<float>(300001, 256 * 1024);
+        });
+
+        it("test external sort one run", [&]() {
+            external_test<int32_t>(5000, 1024 * 1024);
+        });
+
+        it("test external sort empty", [&]() {
+            external_test<int32_t>(0, 1024 * 1024);
+        });
+
+        it("test external sort missing input", [&]() {
+            bool thrown = false;
+            try {
+                floki::external_sort<int32_t>("floki_no_such_file.bin",
+                                              "floki_external_output.bin",
+                                              1024 * 1024);
+            } catch (const std::system_error &) {
+                thrown = true;
+            }
+            AssertThat(thrown, IsTrue());
+        });
+    });
+});
+
+int main(int argc, char *argv[])
+{
+    return bandit::run(argc, argv);
+}
@@ -9,10 +9,47 @@ using namespace bandit;
 #include <cassert>
 #include <numeric>
 
+#include <random>
+#include <limits>
+
 #include <floki/kary_search.hpp>
+#include <floki/kary_index.hpp>
 
 using namespace std;
 
+template <typename key_t, uint32_t k>
+void kary_index_test(const std::vector<key_t> &sorted_values,
+                     const std::vector<key_t> &test_values) {
+  floki::kary_index<key_t, k> index(sorted_values.begin(),
+                                    sorted_values.end());
+  AssertThat(index.size(), Equals(sorted_values.size()));
+  AssertThat(index.stored_size(), IsLessThan(2 * sorted_values.size() + k));
+
+  std::vector<size_t> batch(test_values.size());
+  floki::bfs::search_batch(index, test_values.data(), test_values.size(),
+                           batch.begin());
+
+  for (size_t i = 0; i < test_values.size(); ++i) {
+    auto stl = std::lower_bound(begin(sorted_values), end(sorted_values),
+                                test_values[i]);
+    auto expected = size_t(std::distance(begin(sorted_values), stl));
+    AssertThat(index.search(test_values[i]), Equals(expected));
+    AssertThat(batch[i], Equals(expected));
+  }
+}
+
+template <typename key_t, uint32_t k> void kary_index_lengths_test() {
+  for (size_t elements = 0; elements < 400; ++elements) {
+    std::vector<key_t> sorted_values(elements);
+    for (size_t i = 0; i < elements; ++i) {
+      sorted_values[i] = key_t(2 * i);
+    }
+    std::vector<key_t> test_values(2 * elements + 3);
+    std::iota(test_values.begin(), test_values.end(), key_t(-1));
+    kary_index_test<key_t, k>(sorted_values, test_values);
+  }
+}
+
 go_bandit([]() {
 
   describe("kary class tests", []() {
@@ -72,6 +109,151 @@ go_bandit([]() {
         AssertThat(std::distance(begin(sorted_values), stl), Equals(sorted));
       }
     });
+
+    it("batch search test", [&]() {
+      using key_t = int32_t;
+      constexpr uint32_t k = 9;
+
+      std::vector<key_t> sorted_values(9 * 9 * 9 - 1);
+      std::iota(sorted_values.begin(), sorted_values.end(), 0);
+
+      std::vector<key_t> linearized_values(sorted_values.size());
+      floki::bfs::linearize<k>(sorted_values.begin(), sorted_values.end(),
+                               linearized_values.begin());
+
+      std::mt19937 engine(1);
+      std::uniform_int_distribution<key_t> distribution(-10, 740);
+
+      for (size_t n : {0, 1, 15, 16, 17, 100, 1000}) {
+        std::vector<key_t> test_values(n);
+        std::generate(begin(test_values), end(test_values),
+                      [&] { return distribution(engine); });
+
+        std::vector<uint32_t> batch(n);
+        floki::bfs::search_batch<key_t, k>(
+            &linearized_values[0],
+            &linearized_values[0] + linearized_values.size(),
+            test_values.data(), n, batch.begin());
+
+        for (size_t i = 0; i < n; ++i) {
+          AssertThat(batch[i],
+                     Equals(floki::bfs::search<key_t, k>(
+                         &linearized_values[0],
+                         &linearized_values[0] + linearized_values.size(),
+                         test_values[i])));
+        }
+      }
+    });
+  });
+
+  describe("kary linearize", []() {
+
+    it("linearize matches the paper mapping", [&]() {
+      for (uint32_t k : {2, 3, 5, 9, 17}) {
+        for (uint32_t N = k; N <= 100000; N *= k) {
+          std::vector<int32_t> sorted_values(N - 1);
+          std::iota(sorted_values.begin(), sorted_values.end(), 0);
+
+          std::vector<int32_t> expected(N - 1);
+          std::copy(sorted_values.begin(), sorted_values.end(),
+                    floki::bfs::make_iterator(&expected[0], k, N, 0));
+
+          std::vector<int32_t> linearized(N - 1);
+          floki::bfs::linearize<int32_t>(&sorted_values[0], k, N,
+                                         &linearized[0]);
+          AssertThat(linearized, EqualsContainer(expected));
+        }
+      }
+    });
+
+    it("linearize empty", [&]() {
+      std::vector<int32_t> sorted_values, linearized;
+      floki::bfs::linearize<5>(sorted_values.begin(), sorted_values.end(),
+                               linearized.begin());
+      AssertThat(linearized.empty(), IsTrue());
+    });
+
+    it("linearize threads", [&]() {
+      constexpr uint32_t k = 9;
+      const size_t N = 9 * 9 * 9 * 9 * 9 * 9;
+      std::vector<int32_t> sorted_values(N - 1);
+      std::iota(sorted_values.begin(), sorted_values.end(), 0);
+
+      std::vector<int32_t> expected(N - 1);
+      floki::bfs::linearize<k>(sorted_values.begin(), sorted_values.end(),
+                               expected.begin());
+
+      for (unsigned threads : {2, 3, 8}) {
+        std::vector<int32_t> linearized(N - 1);
+        floki::bfs::linearize<k>(sorted_values.begin(), sorted_values.end(),
+                                 linearized.begin(), threads);
+        AssertThat(linearized, EqualsContainer(expected));
+      }
+
+      std::vector<int32_t> test_values = {-1, 0, 1, 1000, 531440, 531441};
+      kary_index_test<int32_t, 17>(sorted_values, test_values);
+
+      floki::kary_index<int32_t, 17> index(sorted_values.begin(),
+                                           sorted_values.end());
+      floki::kary_index<int32_t, 17> threaded(sorted_values.begin(),
+                                              sorted_values.end(), 4);
+      AssertThat(std::equal(index.data(), index.data() + index.stored_size(),
+                            threaded.data()),
+                 IsTrue());
+    });
+  });
+
+  describe("kary index", []() {
+
+    it("kary index lengths", [&]() {
+      kary_index_lengths_test<int32_t, 2>();
+      kary_index_lengths_test<int32_t, 5>();
+      kary_index_lengths_test<int32_t, 9>();
+      kary_index_lengths_test<int32_t, 17>();
+      kary_index_lengths_test<float, 5>();
+      kary_index_lengths_test<int64_t, 9>();
+    });
+
+    it("kary index duplicates and limits", [&]() {
+      std::vector<int32_t> sorted_values = {
+          std::numeric_limits<int32_t>::min(), -5, -5, 0, 0, 0, 7, 7,
+          std::numeric_limits<int32_t>::max(),
+          std::numeric_limits<int32_t>::max()};
+      std::vector<int32_t> test_values = {
+          std::numeric_limits<int32_t>::min(), -6, -5, -1, 0, 1, 7, 8,
+          std::numeric_limits<int32_t>::max()};
+      kary_index_test<int32_t, 5>(sorted_values, test_values);
+      kary_index_test<int32_t, 17>(sorted_values, test_values);
+    });
+
+    it("kary index large", [&]() {
+      std::mt19937 engine(1);
+      std::uniform_int_distribution<int32_t> distribution;
+
+      std::vector<int32_t> sorted_values(1000003);
+      std::generate(begin(sorted_values), end(sorted_values),
+                    [&] { return distribution(engine); });
+      std::sort(begin(sorted_values), end(sorted_values));
+
+      std::vector<int32_t> test_values(10000);
+      std::generate(begin(test_values), end(test_values),
+                    [&] { return distribution(engine); });
+      std::copy(sorted_values.begin(), sorted_values.begin() + 1000,
+                std::back_inserter(test_values));
+
+      kary_index_test<int32_t, 17>(sorted_values, test_values);
+    });
+
+    it("kary index empty", [&]() {
+      floki::kary_index<int32_t, 9> index;
+      AssertThat(index.empty(), IsTrue());
+      AssertThat(index.search(3), Equals(0u));
+
+      std::vector<int32_t> keys = {1, 2, 3};
+      std::vector<size_t> positions(3, 7);
+      index.search_batch(keys.data(), keys.size(), positions.begin());
+      AssertThat(positions, EqualsContainer(std::vector<size_t>(3, 0)));
+    });
   });
 });
 int main(int argc, char *argv[]) { return bandit::run(argc, argv); }
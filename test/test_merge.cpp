@@ -0,0 +1,113 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/merge.hpp>
+
+#include "random_values.hpp"
+
+
+template <typename element_type>
+void merge_test(size_t a_elements, size_t b_elements, unsigned threads)
+{
+    auto a = sorted_random_values<element_type>(a_elements, 0, 1000, 1);
+    auto b = sorted_random_values<element_type>(b_elements, 0, 1000, 2);
+
+    std::vector<element_type> expected(a_elements + b_elements);
+    std::merge(begin(a), end(a), begin(b), end(b), begin(expected));
+
+    std::vector<element_type> output(a_elements + b_elements + 1, -1);
+    auto out_end = floki::merge(begin(a), end(a), begin(b), end(b),
+                                begin(output), threads);
+
+    AssertThat(out_end == end(output) - 1, IsTrue());
+    AssertThat(output.back(), Equals(element_type(-1)));
+    output.pop_back();
+    AssertThat(output, EqualsContainer(expected));
+}
+
+template <typename element_type>
+void inplace_merge_test(size_t a_elements, size_t b_elements, unsigned threads)
+{
+    auto values = sorted_random_values<element_type>(a_elements, 0, 1000, 3);
+    auto b = sorted_random_values<element_type>(b_elements, 0, 1000, 4);
+    values.insert(end(values), begin(b), end(b));
+
+    auto expected = values;
+    std::inplace_merge(begin(expected), begin(expected) + a_elements,
+                       end(expected));
+
+    floki::inplace_merge(begin(values), begin(values) + a_elements,
+                         end(values), threads);
+
+    AssertThat(values, EqualsContainer(expected));
+}
+
+go_bandit([]() {
+
+    describe("test merge", []() {
+
+        it("test merge lengths", [&]() {
+            for (size_t a : { 0, 1, 7, 16, 33, 100 }) {
+                for (size_t b : { 0, 3, 16, 65 }) {
+                    merge_test<int32_t>(a, b, 1);
+                }
+            }
+        });
+
+        it("test merge int64_t", [&]() {
+            merge_test<int64_t>(1001, 777, 1);
+        });
+
+        it("test merge threads", [&]() {
+            merge_test<int32_t>(300001, 200003, 4);
+        });
+
+        it("test merge skewed threads", [&]() {
+            merge_test<int32_t>(500000, 17, 3);
+        });
+
+        it("test merge descending", [&]() {
+            auto a = sorted_random_values<int32_t>(1000, 0, 1000, 5);
+            auto b = sorted_random_values<int32_t>(333, 0, 1000, 6);
+            std::reverse(begin(a), end(a));
+            std::reverse(begin(b), end(b));
+
+            std::vector<int32_t> expected(a.size() + b.size());
+            std::merge(begin(a), end(a), begin(b), end(b), begin(expected),
+                       std::greater<int32_t>());
+
+            std::vector<int32_t> output(a.size() + b.size());
+            floki::merge<floki::descending>(begin(a), end(a), begin(b), end(b),
+                                            begin(output));
+
+            AssertThat(output, EqualsContainer(expected));
+        });
+
+        it("test inplace merge", [&]() {
+            for (size_t a : { 0, 1, 9, 100, 1000 }) {
+                for (size_t b : { 0, 5, 64, 999 }) {
+                    inplace_merge_test<int32_t>(a, b, 1);
+                }
+            }
+        });
+
+        it("test inplace merge threads", [&]() {
+            inplace_merge_test<int32_t>(400000, 300001, 4);
+        });
+
+        it("test inplace merge sorted delta", [&]() {
+            inplace_merge_test<int32_t>(200000, 50, 1);
+            inplace_merge_test<float>(3, 200000, 1);
+        });
+    });
+});
+
+int main(int argc, char *argv[])
+{
+    return bandit::run(argc, argv);
+}
@@ -0,0 +1,109 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/multiway_sort.hpp>
+
+#include "random_values.hpp"
+
+template <typename element_type>
+void multiway_random_test(size_t elements, size_t chunk, size_t ways,
+                          size_t segment, element_type max_value)
+{
+    auto values = random_values<element_type>(elements, 0, max_value, elements);
+    auto sorted_values = values;
+
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    floki::detail::multiway_sort(begin(values), end(values), chunk, ways,
+                                 segment);
+
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
+void multiway_split_test(size_t runs, size_t run_elements, int32_t max_value)
+{
+    auto values = random_values<int32_t>(runs * run_elements + runs / 2, 0,
+                                         max_value, runs);
+
+    std::vector<size_t> bounds;
+    for (size_t r = 0; r < runs; ++r) {
+        // uneven runs, including empty ones
+        bounds.push_back(r * run_elements + (r % 3 == 0 ? r / 2 : 0));
+    }
+    bounds.push_back(values.size());
+    for (size_t r = 0; r < runs; ++r) {
+        std::sort(begin(values) + bounds[r], begin(values) + bounds[r + 1]);
+    }
+
+    auto sorted_values = values;
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    std::vector<size_t> splits(runs);
+    for (size_t rank = 0; rank <= values.size(); rank += 7) {
+        floki::detail::multiway_split(begin(values), &bounds[0], runs, rank,
+                                      &splits[0]);
+
+        std::vector<int32_t> below;
+        for (size_t r = 0; r < runs; ++r) {
+            AssertThat(splits[r] >= bounds[r] && splits[r] <= bounds[r + 1],
+                       IsTrue());
+            below.insert(end(below), begin(values) + bounds[r],
+                         begin(values) + splits[r]);
+        }
+        std::sort(begin(below), end(below));
+
+        AssertThat(below.size(), Equals(rank));
+        AssertThat(std::equal(begin(below), end(below), begin(sorted_values)),
+                   IsTrue());
+    }
+}
+
+go_bandit([]() {
+
+    describe("test multiway sort", []() {
+
+        it("test multiway split", [&]() {
+            multiway_split_test(5, 40, 1000);
+        });
+
+        it("test multiway split duplicates", [&]() {
+            multiway_split_test(8, 33, 3);
+        });
+
+        it("test multiway sort one pass", [&]() {
+            multiway_random_test<int32_t>(1000, 128, 16, 96, 1 << 30);
+        });
+
+        it("test multiway sort two passes", [&]() {
+            multiway_random_test<int32_t>(3000, 100, 4, 64, 1 << 30);
+        });
+
+        it("test multiway sort three passes", [&]() {
+            multiway_random_test<int32_t>(4099, 64, 3, 48, 50);
+        });
+
+        it("test multiway sort int64", [&]() {
+            multiway_random_test<int64_t>(2049, 64, 5, 40, 1 << 20);
+        });
+
+        it("test multiway sort large", [&]() {
+            auto values = random_values<int32_t>(1000000, 0, 1 << 30, 1);
+            auto sorted_values = values;
+
+            std::sort(begin(sorted_values), end(sorted_values));
+
+            floki::multiway_sort(begin(values), end(values));
+
+            AssertThat(values, EqualsContainer(sorted_values));
+        });
+    });
+});
+
+int main(int argc, char *argv[])
+{
+    return bandit::run(argc, argv);
+}
@@ -0,0 +1,126 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/parallel_sort.hpp>
+
+template <typename element_type>
+void parallel_random_test(size_t elements, unsigned threads)
+{
+    std::vector<element_type> values(elements);
+    using distribution_t = typename std::conditional
+        <std::is_integral<element_type>::value,
+         typename std::uniform_int_distribution<element_type>,
+         typename std::uniform_real_distribution<element_type>>::type;
+    distribution_t distribution;
+    std::mt19937 engine;
+    auto generator = std::bind(distribution, engine);
+    std::generate_n(values.begin(), elements, generator);
+
+    auto sorted_values = values;
+
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    floki::parallel_sort(begin(values), end(values), threads);
+
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
+template <typename element_type>
+void merge_n_test(size_t a_elements, size_t b_elements)
+{
+    std::vector<element_type> a(a_elements), b(b_elements);
+    std::mt19937 engine(static_cast<uint32_t>(a_elements * 31 + b_elements));
+    std::uniform_int_distribution<int32_t> distribution(0, 100);
+    std::generate(begin(a), end(a), [&] { return distribution(engine); });
+    std::generate(begin(b), end(b), [&] { return distribution(engine); });
+    std::sort(begin(a), end(a));
+    std::sort(begin(b), end(b));
+
+    std::vector<element_type> merged(a_elements + b_elements);
+    std::merge(begin(a), end(a), begin(b), end(b), begin(merged));
+
+    std::vector<element_type> output(a_elements + b_elements + 1, -1);
+    floki::detail::merge_n<4>(begin(a), a_elements, begin(b), b_elements,
+                              begin(output));
+
+    AssertThat(output.back(), Equals(element_type(-1)));
+    output.pop_back();
+    AssertThat(output, EqualsContainer(merged));
+}
+
+go_bandit([]() {
+
+    describe("test parallel sort", []() {
+
+        it("test merge path", [&]() {
+            std::vector<int32_t> a = { 1, 3, 5, 7, 9, 11 };
+            std::vector<int32_t> b = { 2, 4, 6, 8 };
+
+            for (size_t diagonal = 0; diagonal <= a.size() + b.size();
+                 ++diagonal) {
+                size_t taken = floki::detail::merge_path(
+                    begin(a), a.size(), begin(b), b.size(), diagonal);
+
+                std::vector<int32_t> merged(a.size() + b.size());
+                std::merge(begin(a), end(a), begin(b), end(b), begin(merged));
+                auto expected = std::count_if(
+                    begin(merged), begin(merged) + diagonal,
+                    [](int32_t v) { return v % 2 == 1; });
+
+                AssertThat(taken, Equals(size_t(expected)));
+            }
+        });
+
+        it("test merge any length", [&]() {
+            for (size_t a_elements : { 0, 1, 7, 8, 9, 16, 23, 100 }) {
+                for (size_t b_elements : { 0, 1, 5, 8, 15, 64, 77 }) {
+                    merge_n_test<int32_t>(a_elements, b_elements);
+                }
+            }
+        });
+
+        it("test merge any length float", [&]() {
+            merge_n_test<float>(37, 91);
+        });
+
+        it("test parallel sort small input",
+           [&]() { parallel_random_test<int32_t>(4096, 4); });
+
+        it("test parallel sort 2 threads",
+           [&]() { parallel_random_test<int32_t>(300000, 2); });
+
+        it("test parallel sort 3 threads",
+           [&]() { parallel_random_test<int32_t>(300001, 3); });
+
+        it("test parallel sort 4 threads",
+           [&]() { parallel_random_test<int32_t>(1 << 19, 4); });
+
+        it("test parallel sort 5 threads float",
+           [&]() { parallel_random_test<float>(400007, 5); });
+
+        it("test parallel sort reverse sorted array", [&]() {
+            const size_t elements = 8 * 65536 + 13;
+            int n(elements);
+            std::vector<int32_t> values(elements);
+
+            std::generate(begin(values), end(values), [&] { return n--; });
+
+            auto sorted_values = values;
+
+            std::sort(begin(sorted_values), end(sorted_values));
+
+            floki::parallel_sort(begin(values), end(values), 6);
+
+            AssertThat(values, EqualsContainer(sorted_values));
+        });
+    });
+});
+
+int main(int argc, char *argv[])
+{
+    return bandit::run(argc, argv);
+}
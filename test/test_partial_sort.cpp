@@ -0,0 +1,132 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/partial_sort.hpp>
+
+#include "random_values.hpp"
+
+template <typename element_type>
+void top_k_test(size_t elements, size_t k, element_type max_value)
+{
+    auto values = random_values<element_type>(elements, 0, max_value, elements);
+    auto sorted_values = values;
+    std::sort(begin(sorted_values), end(sorted_values));
+    sorted_values.resize(std::min(k, elements));
+
+    auto smallest = floki::top_k(begin(values), end(values), k);
+
+    AssertThat(smallest, EqualsContainer(sorted_values));
+}
+
+template <typename element_type>
+void partial_sort_test(size_t elements, size_t k, element_type max_value)
+{
+    auto values = random_values<element_type>(elements, 0, max_value, elements);
+    auto expected = values;
+    std::partial_sort(begin(expected), begin(expected) + k, end(expected));
+
+    floki::partial_sort(begin(values), begin(values) + k, end(values));
+
+    AssertThat(std::equal(begin(values), begin(values) + k, begin(expected)),
+               IsTrue());
+
+    std::sort(begin(values) + k, end(values));
+    std::sort(begin(expected) + k, end(expected));
+    AssertThat(values, EqualsContainer(expected));
+}
+
+template <typename element_type>
+void nth_element_test(size_t elements, size_t nth, element_type max_value)
+{
+    auto values = random_values<element_type>(elements, 0, max_value, elements);
+    auto sorted_values = values;
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    floki::nth_element(begin(values), begin(values) + nth, end(values));
+
+    AssertThat(values[nth], Equals(sorted_values[nth]));
+    for (size_t i = 0; i < elements; ++i) {
+        AssertThat(i < nth ? !(values[nth] < values[i])
+                           : !(values[i] < values[nth]),
+                   IsTrue());
+    }
+
+    std::sort(begin(values), end(values));
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
+go_bandit([]() {
+
+    describe("test partial sort", []() {
+
+        it("test top k small k", [&]() {
+            top_k_test<int32_t>(100000, 100, 1 << 30);
+        });
+
+        it("test top k large k", [&]() {
+            top_k_test<int32_t>(20000, 3000, 1 << 30);
+        });
+
+        it("test top k duplicates", [&]() {
+            top_k_test<int32_t>(10007, 50, 20);
+        });
+
+        it("test top k more than elements", [&]() {
+            top_k_test<int32_t>(37, 100, 1000);
+        });
+
+        it("test top k float", [&]() {
+            top_k_test<float>(50001, 17, 1.0f);
+        });
+
+        it("test top k int64_t", [&]() {
+            top_k_test<int64_t>(5003, 64, 1 << 20);
+        });
+
+        it("test top k stream", [&]() {
+            auto values = random_values<int32_t>(30000, 0, 1 << 30, 1);
+            floki::top_k_stream<int32_t> stream(10);
+            for (size_t i = 0; i < values.size(); i += 333) {
+                stream.push(begin(values) + i,
+                            begin(values) + std::min(i + 333, values.size()));
+            }
+
+            std::sort(begin(values), end(values));
+            values.resize(10);
+            AssertThat(stream.values(), EqualsContainer(values));
+        });
+
+        it("test partial sort", [&]() {
+            partial_sort_test<int32_t>(10000, 100, 1 << 30);
+        });
+
+        it("test partial sort duplicates", [&]() {
+            partial_sort_test<int32_t>(4099, 33, 7);
+        });
+
+        it("test partial sort all", [&]() {
+            partial_sort_test<int32_t>(999, 999, 1000);
+        });
+
+        it("test nth element", [&]() {
+            nth_element_test<int32_t>(10000, 17, 1 << 30);
+        });
+
+        it("test nth element duplicates", [&]() {
+            nth_element_test<int32_t>(5000, 400, 9);
+        });
+
+        it("test nth element median", [&]() {
+            nth_element_test<double>(3001, 1500, 1.0);
+        });
+    });
+});
+
+int main(int argc, char *argv[])
+{
+    return bandit::run(argc, argv);
+}
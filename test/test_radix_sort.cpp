@@ -0,0 +1,131 @@
+#define FLOKI_SORT_RADIX
+
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/aa_sort.hpp>
+
+#include "random_values.hpp"
+
+/**
+ * random_values over the whole range of integer types, and [-1000, 1000] for
+ * floating point types.
+ */
+template <typename element_type>
+std::vector<element_type> full_range_values(size_t elements)
+{
+    const bool integral = std::is_integral<element_type>::value;
+    return random_values<element_type>(
+        elements,
+        integral ? std::numeric_limits<element_type>::min() : element_type(-1000),
+        integral ? std::numeric_limits<element_type>::max() : element_type(1000),
+        elements);
+}
+
+template <typename element_type>
+void radix_test(std::vector<element_type> values)
+{
+    auto sorted_values = values;
+
+    std::sort(begin(sorted_values), end(sorted_values));
+
+    floki::radix_sort(begin(values), end(values));
+
+    AssertThat(values, EqualsContainer(sorted_values));
+}
+
+go_bandit([]() {
+
+    describe("test radix sort", []() {
+
+        it("test radix key order", [&]() {
+            std::vector<float> values{ -std::numeric_limits<float>::infinity(),
+                                       -2.5f, -1.0f, -0.0f, 0.0f, 1e-30f,
+                                       1.0f, 3.5f,
+                                       std::numeric_limits<float>::infinity() };
+            for (size_t i = 0; i + 1 < values.size(); ++i) {
+                AssertThat(floki::detail::radix_key(values[i])
+                               <= floki::detail::radix_key(values[i + 1]),
+                           IsTrue());
+            }
+            AssertThat(floki::detail::radix_key(int32_t(-1))
+                           < floki::detail::radix_key(int32_t(0)),
+                       IsTrue());
+        });
+
+        it("test radix sort int32_t", [&]() {
+            radix_test(full_range_values<int32_t>(100003));
+        });
+
+        it("test radix sort uint32_t", [&]() {
+            radix_test(full_range_values<uint32_t>(5000));
+        });
+
+        it("test radix sort float", [&]() {
+            radix_test(full_range_values<float>(20001));
+        });
+
+        it("test radix sort double", [&]() {
+            radix_test(full_range_values<double>(20001));
+        });
+
+        it("test radix sort int64_t", [&]() {
+            radix_test(full_range_values<int64_t>(30000));
+        });
+
+        it("test radix sort uint64_t", [&]() {
+            radix_test(full_range_values<uint64_t>(777));
+        });
+
+        it("test radix sort int16_t", [&]() {
+            radix_test(full_range_values<int16_t>(10000));
+        });
+
+        it("test radix sort uint16_t", [&]() {
+            radix_test(full_range_values<uint16_t>(10000));
+        });
+
+        it("test radix sort int8_t", [&]() {
+            radix_test(full_range_values<int8_t>(1001));
+        });
+
+        it("test radix sort uint8_t", [&]() {
+            radix_test(full_range_values<uint8_t>(1001));
+        });
+
+        it("test radix sort small", [&]() {
+            for (size_t elements = 0; elements < 40; ++elements) {
+                radix_test(full_range_values<int32_t>(elements));
+            }
+        });
+
+        it("test radix sort skipped passes", [&]() {
+            // odd number of passes, the result ends in temp
+            auto values = full_range_values<int32_t>(4096);
+            for (auto &v : values) {
+                v = (v & 0xff00ff) | 0x11000000;
+            }
+            radix_test(values);
+        });
+
+        it("test sort dispatch to radix", [&]() {
+            auto values = full_range_values<int16_t>(
+                floki::detail::radix_crossover<int16_t>::value + 3);
+            auto sorted_values = values;
+            std::sort(begin(sorted_values), end(sorted_values));
+
+            floki::sort(begin(values), end(values));
+
+            AssertThat(values, EqualsContainer(sorted_values));
+        });
+    });
+});
+
+int main(int argc, char *argv[])
+{
+    return bandit::run(argc, argv);
+}
@@ -0,0 +1,85 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+#include <random>
+#include <floki/segmented_sort.hpp>
+
+#include "random_values.hpp"
+
+template <typename element_type, typename offset_type>
+void segmented_sort_test(const std::vector<size_t> &sizes, unsigned threads)
+{
+    // values before the first segment are left alone
+    std::vector<offset_type> offsets(1, 3);
+    for (size_t size : sizes) {
+        offsets.push_back(offsets.back() + size);
+    }
+
+    auto drawn = random_values<int32_t>(offsets.back(), -1000, 1000,
+                                        uint32_t(sizes.size()));
+    std::vector<element_type> values(begin(drawn), end(drawn));
+
+    auto expected = values;
+    for (size_t s = 0; s < sizes.size(); ++s) {
+        std::sort(begin(expected) + offsets[s], begin(expected) + offsets[s + 1]);
+    }
+
+    floki::segmented_sort(begin(values), begin(offsets), sizes.size(), threads);
+
+    AssertThat(values, EqualsContainer(expected));
+}
+
+std::vector<size_t> random_sizes(size_t segments, size_t largest, uint32_t seed)
+{
+    return random_values<size_t>(segments, 0, largest, seed);
+}
+
+go_bandit([]() {
+
+    describe("test segmented sort", []() {
+
+        it("test segmented sort small segments", [&]() {
+            segmented_sort_test<int32_t, uint32_t>(random_sizes(1000, 20, 1), 1);
+        });
+
+        it("test segmented sort every size", [&]() {
+            std::vector<size_t> sizes(300);
+            std::iota(begin(sizes), end(sizes), 0);
+            segmented_sort_test<int32_t, uint32_t>(sizes, 1);
+        });
+
+        it("test segmented sort mixed segments", [&]() {
+            auto sizes = random_sizes(200, 50, 2);
+            sizes[7] = 5000;
+            sizes[100] = 70001;
+            segmented_sort_test<int32_t, size_t>(sizes, 1);
+        });
+
+        it("test segmented sort threads", [&]() {
+            auto sizes = random_sizes(20000, 40, 3);
+            sizes[5] = 100000;
+            segmented_sort_test<int32_t, uint64_t>(sizes, 4);
+            segmented_sort_test<int32_t, uint32_t>(random_sizes(30000, 12, 4), 3);
+        });
+
+        it("test segmented sort types", [&]() {
+            segmented_sort_test<float, uint32_t>(random_sizes(500, 40, 5), 1);
+            segmented_sort_test<int64_t, uint32_t>(random_sizes(500, 40, 6), 1);
+            segmented_sort_test<int16_t, uint32_t>(random_sizes(500, 40, 7), 1);
+            segmented_sort_test<uint8_t, uint32_t>(random_sizes(500, 40, 8), 1);
+            segmented_sort_test<double, uint32_t>(random_sizes(500, 40, 9), 1);
+        });
+
+        it("test segmented sort no segments", [&]() {
+            segmented_sort_test<int32_t, uint32_t>({}, 1);
+            segmented_sort_test<int32_t, uint32_t>({ 0, 0, 1 }, 1);
+        });
+    });
+
+});
+
+int main(int argc, char *argv[]) { return bandit::run(argc, argv); }
@@ -0,0 +1,122 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/set_algorithms.hpp>
+
+#include "random_values.hpp"
+
+/**
+ * sorted set of about elements ids drawn from [0, range).
+ */
+template <typename element_type>
+std::vector<element_type> sorted_set(size_t elements, size_t range,
+                                     uint32_t seed)
+{
+    auto values = sorted_random_values<element_type>(
+        elements, 0, element_type(range - 1), seed);
+    values.erase(std::unique(begin(values), end(values)), end(values));
+    return values;
+}
+
+template <typename element_type>
+void set_test(const std::vector<element_type> &a,
+              const std::vector<element_type> &b)
+{
+    std::vector<element_type> expected;
+    std::vector<element_type> output(a.size() + b.size());
+
+    std::set_intersection(begin(a), end(a), begin(b), end(b),
+                          std::back_inserter(expected));
+    auto out_end = floki::set_intersection(begin(a), end(a), begin(b), end(b),
+                                           begin(output));
+    AssertThat(std::vector<element_type>(begin(output), out_end),
+               EqualsContainer(expected));
+
+    expected.clear();
+    std::set_union(begin(a), end(a), begin(b), end(b),
+                   std::back_inserter(expected));
+    out_end = floki::set_union(begin(a), end(a), begin(b), end(b),
+                               begin(output));
+    AssertThat(std::vector<element_type>(begin(output), out_end),
+               EqualsContainer(expected));
+
+    expected.clear();
+    std::set_difference(begin(a), end(a), begin(b), end(b),
+                        std::back_inserter(expected));
+    out_end = floki::set_difference(begin(a), end(a), begin(b), end(b),
+                                    begin(output));
+    AssertThat(std::vector<element_type>(begin(output), out_end),
+               EqualsContainer(expected));
+}
+
+template <typename element_type>
+void random_set_test(size_t a_elements, size_t b_elements, size_t range)
+{
+    auto a = sorted_set<element_type>(a_elements, range, 1);
+    auto b = sorted_set<element_type>(b_elements, range, 2);
+
+    set_test(a, b);
+    set_test(b, a);
+}
+
+go_bandit([]() {
+
+    describe("test set algorithms", []() {
+
+        it("test set lengths", [&]() {
+            for (size_t a : { 0, 1, 4, 7, 16, 33, 100 }) {
+                for (size_t b : { 0, 3, 8, 16, 65 }) {
+                    random_set_test<uint32_t>(a, b, 150);
+                }
+            }
+        });
+
+        it("test set overlap", [&]() {
+            for (size_t range : { 1000, 4000, 100000 }) {
+                random_set_test<uint32_t>(1000, 1000, range);
+            }
+        });
+
+        it("test set gallop", [&]() {
+            random_set_test<uint32_t>(20, 5000, 10000);
+            random_set_test<uint32_t>(1, 5000, 10000);
+            random_set_test<uint32_t>(100, 100000, 100000);
+        });
+
+        it("test set equal", [&]() {
+            auto a = sorted_set<uint32_t>(1000, 2000, 3);
+            set_test(a, a);
+        });
+
+        it("test set disjoint", [&]() {
+            auto a = sorted_set<uint32_t>(500, 1000, 4);
+            std::vector<uint32_t> b(a.size());
+            std::transform(begin(a), end(a), begin(b),
+                           [](uint32_t v) { return v + 1000; });
+            set_test(a, b);
+            set_test(b, a);
+        });
+
+        it("test set max id", [&]() {
+            auto a = sorted_set<uint32_t>(100, 200, 5);
+            auto b = sorted_set<uint32_t>(90, 200, 6);
+            a.push_back(std::numeric_limits<uint32_t>::max());
+            b.push_back(std::numeric_limits<uint32_t>::max());
+            set_test(a, b);
+        });
+
+        it("test set types", [&]() {
+            random_set_test<uint8_t>(100, 120, 256);
+            random_set_test<int16_t>(700, 500, 2000);
+            random_set_test<uint64_t>(900, 1100, 3000);
+            random_set_test<int32_t>(900, 1100, 3000);
+        });
+    });
+
+});
+
+int main(int argc, char *argv[]) { return bandit::run(argc, argv); }
@@ -0,0 +1,126 @@
+#define FLOKI_SORT_STATS
+#define FLOKI_SORT_RADIX
+
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <random>
+#include <floki/aa_sort.hpp>
+
+#include "random_values.hpp"
+
+
+size_t phase_count(const floki::sort_stats &stats, const char *name)
+{
+    return std::count_if(begin(stats.phases), end(stats.phases),
+                         [&](const floki::sort_phase &phase) {
+        return !std::strcmp(phase.name, name);
+    });
+}
+
+go_bandit([]() {
+
+    describe("test sort stats", []() {
+
+        it("test sort stats merge phases", [&]() {
+            auto values = random_values<float>(10007, -1000000, 1000000, 1);
+            auto expected = values;
+            std::sort(begin(expected), end(expected));
+
+            floki::sort_stats stats;
+            {
+                floki::sort_stats_scope scope(stats);
+                floki::sort<floki::descending>(begin(values), end(values));
+            }
+            std::reverse(begin(values), end(values));
+            AssertThat(values, EqualsContainer(expected));
+
+            AssertThat(phase_count(stats, "block sort"), IsGreaterThan(0u));
+            AssertThat(phase_count(stats, "merge pass"), IsGreaterThan(0u));
+            AssertThat(phase_count(stats, "tail merge"), Equals(1u));
+            AssertThat(phase_count(stats, "radix pass"), Equals(0u));
+
+            for (const auto &phase : stats.phases) {
+                AssertThat(phase.wall_ms >= 0, IsTrue());
+                if (!stats.counters) {
+                    AssertThat(phase.cycles, Equals(0u));
+                }
+            }
+            AssertThat(stats.wall_ms("merge pass") >= 0, IsTrue());
+        });
+
+        it("test sort stats radix phases", [&]() {
+            const size_t elements
+                = floki::detail::radix_crossover<int32_t>::value + 1;
+            auto values
+                = random_values<int32_t>(elements, -1000000, 1000000, 1);
+            auto expected = values;
+            std::sort(begin(expected), end(expected));
+
+            floki::sort_stats stats;
+            {
+                floki::sort_stats_scope scope(stats);
+                floki::sort(begin(values), end(values));
+            }
+            AssertThat(values, EqualsContainer(expected));
+
+            AssertThat(phase_count(stats, "radix histogram"), Equals(1u));
+            AssertThat(phase_count(stats, "radix pass"), IsGreaterThan(0u));
+            AssertThat(phase_count(stats, "radix pass"),
+                       IsLessThan(sizeof(int32_t) + 1));
+        });
+
+        it("test sort stats outside scope", [&]() {
+            floki::sort_stats stats;
+            {
+                floki::sort_stats_scope scope(stats);
+            }
+            auto values = random_values<int32_t>(1000, -1000000, 1000000, 1);
+            floki::sort(begin(values), end(values));
+            AssertThat(stats.phases.size(), Equals(0u));
+            AssertThat(std::is_sorted(begin(values), end(values)),
+                       IsTrue());
+        });
+
+        it("test sort stats phase started before scope", [&]() {
+            floki::sort_stats stats;
+            std::unique_ptr<floki::detail::phase_recorder> phase(
+                new floki::detail::phase_recorder("outer"));
+            floki::sort_stats_scope scope(stats);
+            phase.reset();
+            AssertThat(stats.phases.size(), Equals(0u));
+        });
+
+        it("test sort stats scope closed before phase ends", [&]() {
+            floki::sort_stats stats;
+            std::unique_ptr<floki::detail::phase_recorder> phase;
+            {
+                floki::sort_stats_scope scope(stats);
+                phase.reset(new floki::detail::phase_recorder("outer"));
+            }
+            floki::sort_stats_scope scope(stats);
+            phase.reset();
+            AssertThat(stats.phases.size(), Equals(0u));
+        });
+
+        it("test sort stats clear", [&]() {
+            floki::sort_stats stats;
+            floki::sort_stats_scope scope(stats);
+
+            auto values = random_values<int32_t>(5000, -1000000, 1000000, 1);
+            floki::sort(begin(values), end(values));
+            AssertThat(stats.phases.size(), IsGreaterThan(0u));
+
+            stats.clear();
+            AssertThat(stats.phases.size(), Equals(0u));
+            AssertThat(stats.wall_ms("block sort"), Equals(0.0));
+        });
+    });
+
+});
+
+int main(int argc, char *argv[]) { return bandit::run(argc, argv); }
@@ -0,0 +1,113 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/static_sort.hpp>
+
+#include "random_values.hpp"
+
+/**
+ * values in [-100, 100], unsigned types wrap the negative ones to just below
+ * their largest value, the sentinel of the sorting network.
+ */
+template <typename element_type>
+std::vector<element_type> small_values(size_t elements, uint32_t seed)
+{
+    using draw_t = typename std::conditional
+        <std::is_integral<element_type>::value, int32_t, element_type>::type;
+    auto values = random_values<draw_t>(elements, -100, 100, seed);
+    return std::vector<element_type>(begin(values), end(values));
+}
+
+template <size_t N, typename element_type> void static_sort_test()
+{
+    // the values around the N sorted are left alone
+    auto values = small_values<element_type>(N + 2, N);
+    auto expected = values;
+    std::sort(begin(expected) + 1, end(expected) - 1);
+
+    floki::static_sort<N>(begin(values) + 1);
+
+    AssertThat(values, EqualsContainer(expected));
+}
+
+template <size_t N, typename element_type> void static_sort_descending_test()
+{
+    auto values = small_values<element_type>(N, N + 1);
+    auto expected = values;
+    std::sort(begin(expected), end(expected), std::greater<element_type>());
+
+    floki::static_sort<N, floki::descending>(begin(values));
+
+    AssertThat(values, EqualsContainer(expected));
+}
+
+/**
+ * runs static_sort_test for every N in [1, last].
+ */
+template <size_t last, typename element_type, size_t N = 1>
+typename std::enable_if<(N > last)>::type static_sort_up_to()
+{
+}
+
+template <size_t last, typename element_type, size_t N = 1>
+typename std::enable_if<(N <= last)>::type static_sort_up_to()
+{
+    static_sort_test<N, element_type>();
+    static_sort_up_to<last, element_type, N + 1>();
+}
+
+go_bandit([]() {
+
+    describe("test static sort", []() {
+
+        it("test static sort int32_t every N", [&]() {
+            static_sort_up_to<64, int32_t>();
+        });
+
+        it("test static sort large N", [&]() {
+            static_sort_test<96, int32_t>();
+            static_sort_test<128, int32_t>();
+            static_sort_test<256, int32_t>();
+        });
+
+        it("test static sort float every N", [&]() {
+            static_sort_up_to<64, float>();
+        });
+
+        it("test static sort types", [&]() {
+            static_sort_test<8, int64_t>();
+            static_sort_test<32, int64_t>();
+            static_sort_test<64, double>();
+            static_sort_test<16, int16_t>();
+            static_sort_test<64, uint16_t>();
+            static_sort_test<32, uint8_t>();
+            static_sort_test<64, int8_t>();
+        });
+
+        it("test static sort descending", [&]() {
+            static_sort_descending_test<8, int32_t>();
+            static_sort_descending_test<16, int32_t>();
+            static_sort_descending_test<32, float>();
+            static_sort_descending_test<64, int32_t>();
+        });
+
+        it("test static sort array", [&]() {
+            std::array<int32_t, 16> values = { 9, 3, -1, 14, 0, 2, 7, 7,
+                                               12, -8, 5, 1, 100, 4, 6, 11 };
+            auto expected = values;
+            std::sort(begin(expected), end(expected));
+
+            floki::static_sort(values);
+
+            AssertThat(values, EqualsContainer(expected));
+        });
+    });
+
+});
+
+int main(int argc, char *argv[]) { return bandit::run(argc, argv); }
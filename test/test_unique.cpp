@@ -0,0 +1,114 @@
+#include <bandit/bandit.h>
+using namespace bandit;
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <random>
+#include <floki/unique.hpp>
+
+#include "random_values.hpp"
+
+/**
+ * elements integer values drawn from [0, range), so a small range gives long
+ * runs of duplicates once sorted.
+ */
+template <typename element_type>
+std::vector<element_type> duplicate_values(size_t elements, size_t range,
+                                           uint32_t seed)
+{
+    auto values = random_values<uint64_t>(elements, 0, range - 1, seed);
+    return std::vector<element_type>(begin(values), end(values));
+}
+
+template <typename element_type>
+void unique_test(size_t elements, size_t range)
+{
+    auto values = duplicate_values<element_type>(elements, range, 1);
+    std::sort(begin(values), end(values));
+
+    auto expected = values;
+    expected.erase(std::unique(begin(expected), end(expected)), end(expected));
+
+    std::vector<element_type> copied(elements);
+    auto copied_end = floki::unique_copy(begin(values), end(values),
+                                         begin(copied));
+    copied.erase(copied_end, end(copied));
+    AssertThat(copied, EqualsContainer(expected));
+
+    values.erase(floki::unique(begin(values), end(values)), end(values));
+    AssertThat(values, EqualsContainer(expected));
+}
+
+template <typename element_type>
+void sort_unique_test(size_t elements, size_t range)
+{
+    auto values = duplicate_values<element_type>(elements, range, 2);
+
+    auto expected = values;
+    std::sort(begin(expected), end(expected));
+    expected.erase(std::unique(begin(expected), end(expected)), end(expected));
+
+    values.erase(floki::sort_unique(begin(values), end(values)), end(values));
+    AssertThat(values, EqualsContainer(expected));
+}
+
+go_bandit([]() {
+
+    describe("test unique", []() {
+
+        it("test unique lengths", [&]() {
+            for (size_t elements = 0; elements < 100; ++elements) {
+                unique_test<int32_t>(elements, 10);
+                unique_test<int32_t>(elements, 1000);
+            }
+        });
+
+        it("test unique all equal", [&]() {
+            unique_test<int32_t>(1000, 1);
+        });
+
+        it("test unique types", [&]() {
+            unique_test<uint8_t>(1000, 256);
+            unique_test<int16_t>(1000, 300);
+            unique_test<int64_t>(1000, 300);
+            unique_test<float>(1000, 300);
+        });
+
+        it("test sort unique lengths", [&]() {
+            for (size_t elements = 0; elements < 100; ++elements) {
+                sort_unique_test<int32_t>(elements, 10);
+                sort_unique_test<int32_t>(elements, 1000);
+            }
+        });
+
+        it("test sort unique large", [&]() {
+            sort_unique_test<int32_t>(100003, 5000);
+            sort_unique_test<uint32_t>(65536, 1u << 31);
+        });
+
+        it("test sort unique types", [&]() {
+            sort_unique_test<uint8_t>(5000, 256);
+            sort_unique_test<int16_t>(5000, 1000);
+            sort_unique_test<int64_t>(5000, 1000);
+        });
+
+        it("test sort unique workspace", [&]() {
+            floki::sort_workspace<int32_t> workspace(floki::scratch_size::half);
+            for (size_t elements : { 17, 1000, 4099 }) {
+                auto values = duplicate_values<int32_t>(elements, 500, 3);
+                auto expected = values;
+                std::sort(begin(expected), end(expected));
+                expected.erase(std::unique(begin(expected), end(expected)),
+                               end(expected));
+                values.erase(floki::sort_unique(begin(values), end(values),
+                                                workspace),
+                             end(values));
+                AssertThat(values, EqualsContainer(expected));
+            }
+        });
+    });
+
+});
+
+int main(int argc, char *argv[]) { return bandit::run(argc, argv); }